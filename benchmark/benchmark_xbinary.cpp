@@ -0,0 +1,152 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xbenchmark.hpp"
+
+#include "xwidgets/xbinary.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        const std::vector<std::size_t>& buffer_sizes()
+        {
+            // Typical sizes of compressed and raw images
+            static const std::vector<std::size_t> sizes = { 1u << 20, 8u << 20, 32u << 20 };
+            return sizes;
+        }
+
+        std::vector<char> make_buffer(std::size_t size)
+        {
+            std::vector<char> res(size);
+            std::uint32_t state = 2463534242u;
+            for (auto& c : res)
+            {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                c = static_cast<char>(state);
+            }
+            return res;
+        }
+
+        std::string size_label(std::size_t size)
+        {
+            return std::to_string(size >> 20) + "MB";
+        }
+
+        volatile std::size_t sink = 0;
+    }
+
+    XBENCHMARK(buffer_hash)
+    {
+        for (std::size_t size : buffer_sizes())
+        {
+            auto buffer = make_buffer(size);
+            double t = benchmark::best_time([&]() {
+                sink = static_cast<std::size_t>(buffer_hash(buffer.data(), buffer.size()));
+            });
+            benchmark::report("buffer_hash/" + size_label(size), size, t);
+        }
+    }
+
+    XBENCHMARK(same_buffer)
+    {
+        for (std::size_t size : buffer_sizes())
+        {
+            // Equal contents in distinct storage is the worst case: every
+            // byte is compared.
+            auto lhs = make_buffer(size);
+            auto rhs = lhs;
+            double t = benchmark::best_time([&]() {
+                sink = same_buffer(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+            });
+            benchmark::report("same_buffer/equal/" + size_label(size), size, t);
+
+            rhs.back() ^= 1;
+            t = benchmark::best_time([&]() {
+                sink = same_buffer(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+            });
+            benchmark::report("same_buffer/last_byte_differs/" + size_label(size), size, t);
+        }
+    }
+
+    XBENCHMARK(same_patch_entry)
+    {
+        for (std::size_t size : buffer_sizes())
+        {
+            auto data = make_buffer(size);
+            xeus::buffer_sequence lhs_buffers;
+            lhs_buffers.emplace_back(data.data(), data.size());
+            xeus::buffer_sequence rhs_buffers;
+            rhs_buffers.emplace_back(data.data(), data.size());
+            nl::json lhs = xbuffer_reference_prefix() + "0";
+            nl::json rhs = xbuffer_reference_prefix() + "0";
+            double t = benchmark::best_time([&]() {
+                sink = same_patch_entry(lhs, lhs_buffers, rhs, rhs_buffers);
+            });
+            benchmark::report("same_patch_entry/" + size_label(size), size, t);
+        }
+    }
+
+    XBENCHMARK(patch_entry_hash)
+    {
+        for (std::size_t size : buffer_sizes())
+        {
+            auto data = make_buffer(size);
+            xeus::buffer_sequence buffers;
+            buffers.emplace_back(data.data(), data.size());
+            nl::json entry = xbuffer_reference_prefix() + "0";
+            double t = benchmark::best_time([&]() {
+                sink = patch_entry_hash(entry, buffers);
+            });
+            benchmark::report("patch_entry_hash/" + size_label(size), size, t);
+        }
+    }
+
+    XBENCHMARK(buffer_paths)
+    {
+        // A list of images, each of them sent in its own buffer
+        for (std::size_t count : { 16u, 256u, 1024u })
+        {
+            xbuffer_paths to_check = { { "value" }, { "images", "*" } };
+            nl::json patch;
+            patch["images"] = nl::json::array();
+            nl::json state;
+            state["images"] = nl::json::array();
+            xeus::buffer_sequence buffers;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                patch["images"].push_back(xbuffer_reference_prefix() + std::to_string(i));
+                state["images"].push_back(nullptr);
+                buffers.emplace_back(4);
+            }
+
+            nl::json paths;
+            double t = benchmark::best_time([&]() {
+                extract_buffer_paths(to_check, patch, buffers, paths);
+            });
+            std::cout << std::left << std::setw(33) << "buffer_paths/extract/" + std::to_string(count)
+                      << t * 1e6 << " us/patch" << std::endl;
+
+            t = benchmark::best_time([&]() {
+                nl::json inbound = state;
+                insert_buffer_paths(inbound, paths);
+            });
+            std::cout << std::left << std::setw(33) << "buffer_paths/insert/" + std::to_string(count)
+                      << t * 1e6 << " us/patch" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "xbenchmark.hpp"
+
+#include "xwidgets/ximage.hpp"
+#include "xwidgets/xvideo.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        const std::vector<std::size_t>& media_sizes()
+        {
+            // A compressed frame, a raw 4K frame and a short video
+            static const std::vector<std::size_t> sizes = { 1u << 20, 32u << 20, 64u << 20 };
+            return sizes;
+        }
+
+        std::string size_label(std::size_t size)
+        {
+            return std::to_string(size >> 20) + "MB";
+        }
+
+        template <class W>
+        void media_latency(const std::string& name)
+        {
+            for (std::size_t size : media_sizes())
+            {
+                std::vector<char> data(size, 'a');
+
+                // Copying serialization, as done for std::vector<char> values
+                double t = benchmark::best_time([&]() {
+                    nl::json j;
+                    xeus::buffer_sequence buffers;
+                    xwidgets_serialize(data, j, buffers);
+                });
+                benchmark::report(name + "/serialize_copy/" + size_label(size), size, t);
+
+                // Shared serialization of xbuffer values
+                xbuffer value(data);
+                t = benchmark::best_time([&]() {
+                    nl::json j;
+                    xeus::buffer_sequence buffers;
+                    xwidgets_serialize(value, j, buffers);
+                });
+                benchmark::report(name + "/serialize_shared/" + size_label(size), size, t);
+
+                t = benchmark::best_time([&]() {
+                    auto w = W::initialize().value(value).finalize();
+                });
+                benchmark::report(name + "/open/" + size_label(size), size, t);
+
+                // Alternate between two values so that every update is sent
+                W w;
+                xbuffer other(std::vector<char>(size, 'b'));
+                bool flip = false;
+                t = benchmark::best_time([&]() {
+                    w.value = flip ? value : other;
+                    flip = !flip;
+                });
+                benchmark::report(name + "/update/" + size_label(size), size, t);
+            }
+        }
+    }
+
+    XBENCHMARK(image_latency)
+    {
+        media_latency<image>("image");
+    }
+
+    XBENCHMARK(video_latency)
+    {
+        media_latency<video>("video");
+    }
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "xbenchmark.hpp"
+
+#include "xwidgets/xbutton.hpp"
+#include "xwidgets/xholder.hpp"
+#include "xwidgets/xregistry.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        void report_lookup(const std::string& name, std::size_t count, double seconds)
+        {
+            std::cout << std::left << std::setw(33) << name
+                      << seconds * 1e9 / count << " ns/lookup" << std::endl;
+        }
+
+        volatile std::size_t sink = 0;
+    }
+
+    XBENCHMARK(registry)
+    {
+        for (std::size_t count : { 100u, 10000u })
+        {
+            std::vector<xeus::xguid> ids(count);
+            std::vector<xwidget_id> binary_ids(count);
+            xregistry registry;
+            // The string keyed map formerly backing the registry
+            std::unordered_map<xeus::xguid, xholder> reference;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                ids[i] = xeus::new_xguid();
+                binary_ids[i] = make_widget_id(ids[i]);
+                registry.insert(ids[i], make_id_holder(ids[i]));
+                reference[ids[i]] = make_id_holder(ids[i]);
+            }
+
+            double t = benchmark::best_time([&]() {
+                for (const auto& id : ids)
+                {
+                    sink = reinterpret_cast<std::size_t>(&reference.find(id)->second);
+                }
+            });
+            report_lookup("registry/unordered_map/" + std::to_string(count), count, t);
+
+            t = benchmark::best_time([&]() {
+                for (const auto& id : ids)
+                {
+                    sink = reinterpret_cast<std::size_t>(&registry.find(id));
+                }
+            });
+            report_lookup("registry/find/guid/" + std::to_string(count), count, t);
+
+            t = benchmark::best_time([&]() {
+                for (const auto& id : binary_ids)
+                {
+                    sink = reinterpret_cast<std::size_t>(&registry.find(id));
+                }
+            });
+            report_lookup("registry/find/binary/" + std::to_string(count), count, t);
+
+            t = benchmark::best_time([&]() {
+                for (const auto& id : ids)
+                {
+                    registry.unregister(id);
+                    registry.insert(id, make_id_holder(id));
+                }
+            });
+            report_lookup("registry/unregister_insert/" + std::to_string(count), count, t);
+        }
+    }
+
+    XBENCHMARK(id_holder)
+    {
+        // The children of a large box
+        const std::size_t count = 10000;
+        std::vector<button> widgets(count);
+        std::vector<xholder> children;
+        for (const auto& widget : widgets)
+        {
+            children.push_back(make_id_holder(widget.id()));
+        }
+
+        double t = benchmark::best_time([&]() {
+            nl::json j = children;
+            sink = j.size();
+        });
+        report_lookup("id_holder/to_json/" + std::to_string(count), count, t);
+
+        t = benchmark::best_time([&]() {
+            for (auto& child : children)
+            {
+                sink = child.template get<button>().description().size();
+            }
+        });
+        report_lookup("id_holder/get/" + std::to_string(count), count, t);
+
+        // xbox::add copies the list of children
+        t = benchmark::best_time([&]() {
+            std::vector<xholder> copy = children;
+            sink = copy.size();
+        });
+        report_lookup("id_holder/copy/" + std::to_string(count), count, t);
+    }
+}
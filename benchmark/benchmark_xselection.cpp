@@ -0,0 +1,96 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xbenchmark.hpp"
+
+#include "xwidgets/xdropdown.hpp"
+#include "xwidgets/xoption_index.hpp"
+#include "xwidgets/xselect.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        void report_selection(const std::string& name, std::size_t count, double seconds)
+        {
+            std::cout << std::left << std::setw(33) << name
+                      << seconds * 1e9 / count << " ns/value" << std::endl;
+        }
+
+        std::vector<std::string> make_options(std::size_t count)
+        {
+            std::vector<std::string> options;
+            options.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                options.push_back("option " + std::to_string(i));
+            }
+            return options;
+        }
+
+        volatile std::size_t sink = 0;
+    }
+
+    XBENCHMARK(option_index)
+    {
+        for (std::size_t count : { 10u, 1000u, 100000u })
+        {
+            const std::vector<std::string> options = make_options(count);
+            detail::xoption_index index;
+
+            // The linear search formerly used by the selection widgets
+            double t = benchmark::best_time([&]() {
+                for (const auto& option : options)
+                {
+                    sink = std::size_t(std::find(options.cbegin(), options.cend(), option) - options.cbegin());
+                }
+            });
+            report_selection("option_index/linear/" + std::to_string(count), count, t);
+
+            t = benchmark::best_time([&]() {
+                for (const auto& option : options)
+                {
+                    sink = index.find(options, option);
+                }
+            });
+            report_selection("option_index/find/" + std::to_string(count), count, t);
+        }
+    }
+
+    XBENCHMARK(selection)
+    {
+        for (std::size_t count : { 10u, 1000u, 100000u })
+        {
+            const std::vector<std::string> options = make_options(count);
+            // The last values, the slowest to find linearly
+            const std::vector<std::string> values(options.end() - std::min<std::size_t>(count, 100), options.end());
+
+            dropdown d(options, options.front());
+            double t = benchmark::best_time([&]() {
+                for (const auto& value : values)
+                {
+                    d.value = value;
+                }
+            });
+            report_selection("selection/dropdown/" + std::to_string(count), values.size(), t);
+
+            select_multiple s(options);
+            t = benchmark::best_time([&]() {
+                s.value = values;
+            });
+            report_selection("selection/select_multiple/" + std::to_string(count), values.size(), t);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xbenchmark.hpp"
+
+#include "xwidgets/xslider.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        constexpr std::size_t patch_count = 100000;
+    }
+
+    XBENCHMARK(inbound_patch)
+    {
+        // A continuous_update slider sends its value on every move. The
+        // value is already known to the front-end, so that no message is
+        // sent back and only the application of the patch is measured.
+        slider<double> s;
+        s.value = 1.0;
+        xeus::buffer_sequence buffers;
+        std::vector<nl::json> patches(64, nl::json({{"value", 1.0}}));
+
+        double t = benchmark::best_time([&]() {
+            for (std::size_t i = 0; i < patch_count; ++i)
+            {
+                s.apply_patch(patches[i % patches.size()], buffers);
+            }
+        });
+        std::cout << "inbound_patch/apply_patch        "
+                  << t / patch_count * 1e9 << " ns/patch" << std::endl;
+
+        const auto& table = get_property_table(s);
+        t = benchmark::best_time([&]() {
+            for (std::size_t i = 0; i < patch_count; ++i)
+            {
+                table.apply(&s, patches[i % patches.size()], buffers);
+            }
+        });
+        std::cout << "inbound_patch/property_table     "
+                  << t / patch_count * 1e9 << " ns/patch" << std::endl;
+    }
+
+    XBENCHMARK(state_serialization)
+    {
+        // The full state is sent when a widget is opened, while a patch only
+        // holds the properties that changed.
+        slider<double> s;
+        const auto& table = get_property_table(s);
+        std::vector<std::string> names = {"value"};
+        constexpr std::size_t count = patch_count / 10;
+
+        double t = benchmark::best_time([&]() {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                nl::json state;
+                xeus::buffer_sequence buffers;
+                s.serialize_state(state, buffers);
+            }
+        });
+        std::cout << "state_serialization/full         "
+                  << t / count * 1e9 << " ns/state" << std::endl;
+
+        t = benchmark::best_time([&]() {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                nl::json state;
+                xeus::buffer_sequence buffers;
+                table.serialize(&s, names, state, buffers);
+            }
+        });
+        std::cout << "state_serialization/partial      "
+                  << t / count * 1e9 << " ns/state" << std::endl;
+    }
+
+    XBENCHMARK(request_state)
+    {
+        // Every widget serializes its state when the views of a notebook
+        // reconnect.
+        constexpr std::size_t widget_count = 1000;
+        std::vector<slider<double>> sliders(widget_count);
+        const auto& table = get_property_table(sliders.front());
+
+        double t = benchmark::best_time([&]() {
+            for (auto& s : sliders)
+            {
+                nl::json state;
+                xeus::buffer_sequence buffers;
+                table.serialize(&s, state, buffers);
+            }
+        });
+        std::cout << "request_state/serialize          "
+                  << t / widget_count * 1e9 << " ns/widget" << std::endl;
+
+        t = benchmark::best_time([&]() {
+            for (auto& s : sliders)
+            {
+                nl::json state;
+                xeus::buffer_sequence buffers;
+                s.serialize_state(state, buffers);
+            }
+        });
+        std::cout << "request_state/cached             "
+                  << t / widget_count * 1e9 << " ns/widget" << std::endl;
+    }
+}
@@ -0,0 +1,26 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <string>
+
+#include "xbenchmark.hpp"
+
+int main(int argc, char* argv[])
+{
+    // An optional argument restricts the run to the benchmarks whose name
+    // contains it.
+    std::string filter = argc > 1 ? argv[1] : "";
+    for (const auto& bench : xw::benchmark::registry())
+    {
+        if (bench.first.find(filter) != std::string::npos)
+        {
+            bench.second();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_BENCHMARK_HPP
+#define XWIDGETS_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+
+namespace xw
+{
+    namespace benchmark
+    {
+        using benchmark_function = std::function<void()>;
+
+        inline std::map<std::string, benchmark_function>& registry()
+        {
+            static std::map<std::string, benchmark_function> instance;
+            return instance;
+        }
+
+        struct registrar
+        {
+            registrar(const std::string& name, benchmark_function f)
+            {
+                registry()[name] = std::move(f);
+            }
+        };
+
+        // Best time of `repeat` runs of `f`, in seconds
+        template <class F>
+        inline double best_time(F&& f, std::size_t repeat = 10)
+        {
+            using clock_type = std::chrono::steady_clock;
+            double best = std::numeric_limits<double>::max();
+            for (std::size_t i = 0; i < repeat; ++i)
+            {
+                auto start = clock_type::now();
+                f();
+                auto stop = clock_type::now();
+                best = std::min(best, std::chrono::duration<double>(stop - start).count());
+            }
+            return best;
+        }
+
+        inline void report(const std::string& name, std::size_t bytes, double seconds)
+        {
+            std::cout << std::left << std::setw(40) << name
+                      << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+                      << seconds * 1e3 << " ms"
+                      << std::setw(12) << std::setprecision(2)
+                      << static_cast<double>(bytes) / seconds / 1e9 << " GB/s" << std::endl;
+        }
+    }
+}
+
+#define XBENCHMARK_CONCAT_IMPL(A, B) A##B
+#define XBENCHMARK_CONCAT(A, B) XBENCHMARK_CONCAT_IMPL(A, B)
+
+#define XBENCHMARK(NAME)                                                        \
+    static void XBENCHMARK_CONCAT(NAME, _benchmark)();                          \
+    static ::xw::benchmark::registrar XBENCHMARK_CONCAT(NAME, _registrar)(      \
+        #NAME, &XBENCHMARK_CONCAT(NAME, _benchmark));                           \
+    static void XBENCHMARK_CONCAT(NAME, _benchmark)()
+
+#endif
@@ -30,7 +30,6 @@ namespace xw
         using base_type = xmedia<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json& state, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, format, "mp4");
@@ -54,17 +53,6 @@ namespace xw
      * xaudio implementation *
      *************************/
 
-    template <class D>
-    inline void xaudio<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(format(), state["format"], buffers);
-        xwidgets_serialize(autoplay(), state["autoplay"], buffers);
-        xwidgets_serialize(loop(), state["loop"], buffers);
-        xwidgets_serialize(controls(), state["controls"], buffers);
-    }
-
     template <class D>
     inline void xaudio<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -90,25 +78,6 @@ namespace xw
         this->_view_name() = "AudioView";
     }
 
-    /**********************
-     * custom serializers *
-     **********************/
-
-    inline void set_property_from_patch(decltype(audio::value)& property,
-                                        const nl::json& patch,
-                                        const xeus::buffer_sequence& buffers)
-    {
-        auto it = patch.find(property.name());
-        if (it != patch.end())
-        {
-            using value_type = typename decltype(audio::value)::value_type;
-            std::size_t index = buffer_index(patch[property.name()].template get<std::string>());
-            const auto& value_buffer = buffers[index];
-            const char* value_buf = value_buffer.data<const char>();
-            property = value_type(value_buf, value_buf + value_buffer.size());
-        }
-    }
-
     inline auto audio_from_file(const std::string& filename)
     {
         return audio::initialize().value(read_file(filename));
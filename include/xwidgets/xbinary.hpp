@@ -9,6 +9,9 @@
 #ifndef XWIDGETS_BINARY_HPP
 #define XWIDGETS_BINARY_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <vector>
 
@@ -24,7 +27,62 @@ namespace xw
 {
     using xjson_path_type = std::vector<std::string>;
 
-    XWIDGETS_API void extract_buffer_paths(const std::vector<xjson_path_type>& to_check,
+    /*****************************
+     * xbuffer_paths declaration *
+     *****************************/
+
+    /**
+     * Paths of the values of a widget that may hold buffer references,
+     * compiled into steps with precomputed array indices. A path element
+     * equal to "*" is a wildcard matching every item of an array or object,
+     * such as every image of a list of images.
+     */
+    class XWIDGETS_API xbuffer_paths
+    {
+    public:
+
+        xbuffer_paths() = default;
+        xbuffer_paths(std::initializer_list<xjson_path_type> paths);
+        xbuffer_paths(const std::vector<xjson_path_type>& paths);
+
+        void push_back(const xjson_path_type& path);
+
+        bool empty() const noexcept;
+        std::size_t size() const noexcept;
+        bool contains(const std::string& name) const noexcept;
+
+        void extract(const nl::json& patch,
+                     const xeus::buffer_sequence& buffers,
+                     nl::json& buffer_paths) const;
+
+    private:
+
+        struct step
+        {
+            std::string key;
+            std::size_t index;
+            bool wildcard;
+        };
+
+        struct choice
+        {
+            std::size_t index;
+            const std::string* key;
+        };
+
+        void extract_path(const step* first,
+                          const step* begin,
+                          const step* end,
+                          const nl::json& node,
+                          std::vector<choice>& choices,
+                          nl::json& buffer_paths) const;
+
+        // Steps of all paths, the path i ending at m_ends[i]
+        std::vector<step> m_steps;
+        std::vector<std::size_t> m_ends;
+    };
+
+    XWIDGETS_API void extract_buffer_paths(const xbuffer_paths& to_check,
                                            const nl::json& patch,
                                            const xeus::buffer_sequence& buffers,
                                            nl::json& buffer_paths);
@@ -37,6 +95,19 @@ namespace xw
     XWIDGETS_API bool is_buffer_reference(const std::string& arg);
 
     XWIDGETS_API int buffer_index(const std::string& v);
+
+    XWIDGETS_API std::uint64_t buffer_hash(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+    XWIDGETS_API bool same_buffer(const void* lhs_data, std::size_t lhs_size,
+                                  const void* rhs_data, std::size_t rhs_size);
+
+    XWIDGETS_API std::size_t patch_entry_hash(const nl::json& entry,
+                                              const xeus::buffer_sequence& buffers);
+
+    XWIDGETS_API bool same_patch_entry(const nl::json& lhs,
+                                       const xeus::buffer_sequence& lhs_buffers,
+                                       const nl::json& rhs,
+                                       const xeus::buffer_sequence& rhs_buffers);
 }
 
 #endif
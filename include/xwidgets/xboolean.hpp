@@ -28,7 +28,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, description);
@@ -50,15 +49,6 @@ namespace xw
      * xboolean implementation *
      ***************************/
 
-    template <class D>
-    inline void xboolean<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-    }
-
     template <class D>
     inline void xboolean<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -31,7 +31,6 @@ namespace xw
         using derived_type = D;
         using children_list_type = std::vector<xholder>;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, box_style, "", XEITHER("success", "info", "warning", "danger", ""));
@@ -112,15 +111,6 @@ namespace xw
      * xbox implementation *
      ***********************/
 
-    template <class D>
-    inline void xbox<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(box_style(), state["box_style"], buffers);
-        xwidgets_serialize(children(), state["children"], buffers);
-    }
-
     template <class D>
     inline void xbox<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -0,0 +1,144 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_BUFFER_HPP
+#define XWIDGETS_BUFFER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xmessage.hpp"
+
+#include "xwidgets_config.hpp"
+
+namespace nl = nlohmann;
+
+namespace xw
+{
+    /***********************
+     * xbuffer declaration *
+     ***********************/
+
+    /**
+     * Immutable, reference-counted byte buffer.
+     *
+     * Copies of an xbuffer share the same storage. The storage is handed to
+     * the binary buffers of the messages sent to the front-end, which keep it
+     * alive until they are released, so that sending a value never copies
+     * its bytes. Conversely, an xbuffer built from a received message shares
+     * the content of that message.
+     */
+    class XWIDGETS_API xbuffer
+    {
+    public:
+
+        using value_type = char;
+        using size_type = std::size_t;
+        using const_pointer = const char*;
+        using const_reference = const char&;
+        using const_iterator = const char*;
+        using iterator = const_iterator;
+
+        xbuffer() noexcept;
+        xbuffer(std::vector<char>&& data);
+        xbuffer(const std::vector<char>& data);
+        xbuffer(const char* first, const char* last);
+        xbuffer(std::shared_ptr<const void> owner, const char* data, size_type size) noexcept;
+        explicit xbuffer(const zmq::message_t& message);
+
+        const_pointer data() const noexcept;
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+        const_reference operator[](size_type i) const noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        const std::shared_ptr<const void>& owner() const noexcept;
+
+        zmq::message_t message() const;
+
+        // Copy of the bytes, for code written when media values were vectors
+        operator std::vector<char>() const;
+
+    private:
+
+        std::shared_ptr<const void> p_owner;
+        const char* p_data;
+        size_type m_size;
+    };
+
+    XWIDGETS_API bool operator==(const xbuffer& lhs, const xbuffer& rhs);
+    XWIDGETS_API bool operator!=(const xbuffer& lhs, const xbuffer& rhs);
+
+    XWIDGETS_API void xwidgets_serialize(const xbuffer& value, nl::json& j, xeus::buffer_sequence& buffers);
+    XWIDGETS_API void xwidgets_deserialize(xbuffer& value, const nl::json& j, const xeus::buffer_sequence& buffers);
+
+    /**************************
+     * xbuffer implementation *
+     **************************/
+
+    inline auto xbuffer::data() const noexcept -> const_pointer
+    {
+        return p_data;
+    }
+
+    inline auto xbuffer::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    inline bool xbuffer::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    inline auto xbuffer::operator[](size_type i) const noexcept -> const_reference
+    {
+        return p_data[i];
+    }
+
+    inline auto xbuffer::begin() const noexcept -> const_iterator
+    {
+        return p_data;
+    }
+
+    inline auto xbuffer::end() const noexcept -> const_iterator
+    {
+        return p_data + m_size;
+    }
+
+    inline auto xbuffer::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    inline auto xbuffer::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    inline const std::shared_ptr<const void>& xbuffer::owner() const noexcept
+    {
+        return p_owner;
+    }
+
+    inline xbuffer::operator std::vector<char>() const
+    {
+        return std::vector<char>(begin(), end());
+    }
+}
+
+#endif
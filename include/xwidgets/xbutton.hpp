@@ -19,6 +19,7 @@
 
 #include "xcolor.hpp"
 #include "xeither.hpp"
+#include "xexecutor.hpp"
 #include "xmaterialize.hpp"
 #include "xstyle.hpp"
 #include "xwidget.hpp"
@@ -37,7 +38,6 @@ namespace xw
         using base_type = xstyle<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(xtl::xoptional<html_color>, derived_type, button_color);
@@ -69,11 +69,18 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         void on_click(click_callback_type);
 
+        xevent clicked() const;
+
+        using callback_error_type = xcallback_dispatcher::error_handler_type;
+
+        xcallback_mode callback_mode() const;
+        void set_callback_mode(xcallback_mode);
+        void on_callback_error(callback_error_type);
+
         XPROPERTY(std::string, derived_type, description);
 
         XPROPERTY(std::string, derived_type, tooltip);
@@ -94,6 +101,7 @@ namespace xw
         void set_defaults();
 
         std::list<click_callback_type> m_click_callbacks;
+        xcallback_dispatcher m_dispatcher;
     };
 
     using button = xmaterialize<xbutton>;
@@ -102,15 +110,6 @@ namespace xw
      * xbutton_style implementation *
      ********************************/
 
-    template <class D>
-    inline void xbutton_style<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(button_color(), state["button_color"], buffers);
-        xwidgets_serialize(font_weight(), state["font_weight"], buffers);
-    }
-
     template <class D>
     inline void xbutton_style<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -138,19 +137,6 @@ namespace xw
      * xbutton implementation *
      **************************/
 
-    template <class D>
-    inline void xbutton<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(description(), state["description"], buffers);
-        xwidgets_serialize(tooltip(), state["tooltip"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-        xwidgets_serialize(icon(), state["icon"], buffers);
-        xwidgets_serialize(button_style(), state["button_style"], buffers);
-        xwidgets_serialize(style(), state["style"], buffers);
-    }
-
     template <class D>
     inline void xbutton<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -170,6 +156,30 @@ namespace xw
         m_click_callbacks.emplace_back(std::move(cb));
     }
 
+    template <class D>
+    inline xevent xbutton<D>::clicked() const
+    {
+        return xevent(*this, "click");
+    }
+
+    template <class D>
+    inline xcallback_mode xbutton<D>::callback_mode() const
+    {
+        return m_dispatcher.mode();
+    }
+
+    template <class D>
+    inline void xbutton<D>::set_callback_mode(xcallback_mode mode)
+    {
+        m_dispatcher.set_mode(mode);
+    }
+
+    template <class D>
+    inline void xbutton<D>::on_callback_error(callback_error_type handler)
+    {
+        m_dispatcher.set_error_handler(std::move(handler));
+    }
+
     template <class D>
     inline xbutton<D>::xbutton()
         : base_type()
@@ -194,10 +204,24 @@ namespace xw
         auto it = content.find("event");
         if (it != content.end() && it.value() == "click")
         {
-            for (auto it = m_click_callbacks.begin(); it != m_click_callbacks.end(); ++it)
+            if (m_dispatcher.mode() == xcallback_mode::synchronous)
+            {
+                for (auto it = m_click_callbacks.begin(); it != m_click_callbacks.end(); ++it)
+                {
+                    it->operator()();
+                }
+            }
+            else
             {
-                it->operator()();
+                // Callbacks registered later do not apply to this event
+                m_dispatcher.dispatch(this->id(), [callbacks = m_click_callbacks]() {
+                    for (const auto& callback : callbacks)
+                    {
+                        callback();
+                    }
+                });
             }
+            this->resume_event_waiters("click");
         }
     }
 
@@ -0,0 +1,86 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_CANCELLATION_HPP
+#define XWIDGETS_CANCELLATION_HPP
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "xwidgets_config.hpp"
+
+namespace xw
+{
+    /**
+     * Exception signaling cancelled work: thrown by
+     * xcancellation_token::throw_if_cancelled, and by co_await when the
+     * wait is cancelled (see xcoroutine.hpp).
+     */
+    class xcancelled : public std::exception
+    {
+    public:
+
+        const char* what() const noexcept override
+        {
+            return "widget work cancelled";
+        }
+    };
+
+    /***********************************
+     * xcancellation_token declaration *
+     ***********************************/
+
+    /**
+     * Cancellation flag shared between the code requesting some work and the
+     * code doing it, which checks it periodically to stop early. Tokens may
+     * be checked from any thread. A default-constructed token is never
+     * cancelled.
+     */
+    class XWIDGETS_API xcancellation_token
+    {
+    public:
+
+        xcancellation_token() = default;
+
+        bool cancelled() const noexcept;
+        void throw_if_cancelled() const;
+
+    private:
+
+        explicit xcancellation_token(std::shared_ptr<const std::atomic<bool>> flag) noexcept;
+
+        std::shared_ptr<const std::atomic<bool>> p_flag;
+
+        friend class xcancellation_source;
+    };
+
+    /************************************
+     * xcancellation_source declaration *
+     ************************************/
+
+    /**
+     * Issues the tokens of some work, and cancels them. After cancel, the
+     * source issues new tokens.
+     */
+    class XWIDGETS_API xcancellation_source
+    {
+    public:
+
+        xcancellation_source();
+
+        xcancellation_token token() const noexcept;
+        void cancel();
+
+    private:
+
+        std::shared_ptr<std::atomic<bool>> p_flag;
+    };
+}
+
+#endif
@@ -26,7 +26,6 @@ namespace xw
         using base_type = xboolean<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(bool, derived_type, indent, true);
@@ -48,14 +47,6 @@ namespace xw
      * xcheckbox implementation *
      ****************************/
 
-    template <class D>
-    inline void xcheckbox<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(indent(), state["indent"], buffers);
-    }
-
     template <class D>
     inline void xcheckbox<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
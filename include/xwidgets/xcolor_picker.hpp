@@ -29,7 +29,6 @@ namespace xw
 
         using value_type = html_color;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(value_type, derived_type, value, "black");
@@ -52,16 +51,6 @@ namespace xw
      * xcolor_picker implementation *
      ********************************/
 
-    template <class D>
-    inline void xcolor_picker<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-        xwidgets_serialize(concise(), state["concise"], buffers);
-    }
-
     template <class D>
     inline void xcolor_picker<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
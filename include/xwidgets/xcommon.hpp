@@ -9,13 +9,19 @@
 #ifndef XWIDGETS_COMMON_HPP
 #define XWIDGETS_COMMON_HPP
 
+#include <cstddef>
+#include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "xeus/xcomm.hpp"
 
 #include "xbinary.hpp"
+#include "xcancellation.hpp"
+#include "xproperty_table.hpp"
+#include "xsync_policy.hpp"
 #include "xwidgets_config.hpp"
 
 namespace xw
@@ -38,10 +44,45 @@ namespace xw
         value = j.template get<T>();
     }
 
+    // Binary values, declared before xcommon::notify so that they are found
+    // when serializing property patches.
+
+    inline void xwidgets_serialize(const std::vector<char>& value, nl::json& j, xeus::buffer_sequence& buffers)
+    {
+        j = xbuffer_reference_prefix() + std::to_string(buffers.size());
+        buffers.emplace_back(value.data(), value.size());
+    }
+
     /***********************
      * xcommon declaration *
      ***********************/
 
+    class hold_sync_guard;
+    class xcommon;
+    class xevent;
+
+    namespace detail
+    {
+        // Node of the intrusive list of the waiters for the events of a
+        // widget. Waiters live in coroutine frames, see xcoroutine.hpp.
+        // Triggered waiters are also queued, in the order of sequence, until
+        // resumed with the widget that raised the event as source.
+        struct xevent_waiter
+        {
+            using resume_type = void (*)(xevent_waiter&, bool cancelled);
+
+            std::string event;
+            resume_type resume = nullptr;
+            void* context = nullptr;
+            const xcommon* owner = nullptr;
+            const xcommon* source = nullptr;
+            bool triggered = false;
+            std::size_t sequence = 0;
+            xevent_waiter* prev = nullptr;
+            xevent_waiter* next = nullptr;
+        };
+    }
+
     class XWIDGETS_API xcommon
     {
     public:
@@ -49,6 +90,13 @@ namespace xw
         xeus::xguid id() const noexcept;
         void display() const;
 
+        hold_sync_guard hold_sync();
+
+        void set_sync_policy(const std::string& name, const xsync_policy& policy);
+        xsync_policy sync_policy(const std::string& name) const;
+
+        xcancellation_token cancellation_token(const std::string& name) const;
+
     protected:
 
         xcommon();
@@ -60,24 +108,88 @@ namespace xw
         xcommon& operator=(xcommon&&);
 
         bool moved_from() const noexcept;
+        bool opened() const noexcept;
+        void mark_opened() noexcept;
         void handle_custom_message(const nl::json&);
         xeus::xcomm& comm();
         const xeus::xcomm& comm() const;
         const xeus::xmessage*& hold();
         const xeus::xmessage* const& hold() const;
-        std::vector<xjson_path_type>& buffer_paths();
-        const std::vector<xjson_path_type>& buffer_paths() const;
+        const nl::json*& hold_state();
+        const nl::json* const& hold_state() const;
+        xbuffer_paths& buffer_paths();
+        const xbuffer_paths& buffer_paths() const;
 
         void open(nl::json&& patch, xeus::buffer_sequence&& buffers);
         void close();
 
         template <class T>
         void notify(const std::string& name, const T& value) const;
+        void notify_patch(const std::string& name, nl::json&& patch, xeus::buffer_sequence&& buffers) const;
         void send(nl::json&&, xeus::buffer_sequence&&) const;
         void send_patch(nl::json&&, xeus::buffer_sequence&&) const;
+        void send_state(nl::json&&, xeus::buffer_sequence&&) const;
+        void send_serialized_state(nl::json&&, xeus::buffer_sequence&&) const;
+        void send_property_patch(const std::string&, nl::json&&, xeus::buffer_sequence&&) const;
+        void reset_sent_state(const nl::json& patch);
+        void resume_event_waiters(const std::string& event) const;
+        void cancel_superseded(const std::string& name) const;
+
+        void serialize_cached_state(const xproperty_table& table,
+                                    const void* widget,
+                                    nl::json& state,
+                                    xeus::buffer_sequence& buffers) const;
+        void mark_state_dirty(const std::string&) const;
 
     private:
 
+        using clock_type = xsync_policy::clock_type;
+        using time_point = clock_type::time_point;
+
+        struct xsync_state
+        {
+            xsync_policy policy;
+            time_point last_sent;
+            time_point deadline;
+            bool pending = false;
+            nl::json patch;
+            xeus::buffer_sequence buffers;
+        };
+
+        // Full state serialized by serialize_cached_state, and the
+        // properties changed since then.
+        struct xstate_cache
+        {
+            bool valid = false;
+            std::vector<std::string> dirty;
+            nl::json state;
+            xeus::buffer_sequence buffers;
+        };
+
+        friend class hold_sync_guard;
+        friend class xevent;
+        friend XWIDGETS_API void process_sync_timers();
+        friend XWIDGETS_API void flush();
+
+        void dispatch_patch(nl::json&&, xeus::buffer_sequence&&) const;
+        void send_update(nl::json&&, xeus::buffer_sequence&&) const;
+        void record_sent_state(const nl::json&, const xeus::buffer_sequence&) const;
+
+        void process_sync_timer(time_point now) const;
+        void clear_sync_states();
+
+        void add_event_waiter(detail::xevent_waiter&) const;
+        void remove_event_waiter(detail::xevent_waiter&) const;
+        void cancel_event_waiters() const;
+        void take_event_waiters(const xcommon&);
+        static void resume_triggered_waiters();
+        static void post_resume_task();
+
+        void begin_hold_sync();
+        void end_hold_sync();
+        void hold_patch(nl::json&&, xeus::buffer_sequence&&) const;
+        void flush_held_patch() const;
+
         bool same_patch(const std::string&,
                         const nl::json&,
                         const xeus::buffer_sequence&,
@@ -85,14 +197,140 @@ namespace xw
                         const xeus::buffer_sequence&) const;
 
         bool m_moved_from;
+        // Whether the comm is opened, or its opening posted to the kernel
+        // thread
+        bool m_opened;
         const xeus::xmessage* m_hold;
+        const nl::json* m_hold_state;
         xeus::xcomm m_comm;
-        std::vector<xjson_path_type> m_buffer_paths;
+        xbuffer_paths m_buffer_paths;
+        std::size_t m_hold_sync_depth;
+        mutable nl::json m_held_patch;
+        mutable xeus::buffer_sequence m_held_buffers;
+        mutable std::map<std::string, xsync_state> m_sync_states;
+        mutable std::unordered_map<std::string, std::size_t> m_sent_hashes;
+        mutable xstate_cache m_state_cache;
+        mutable std::unordered_map<std::string, xcancellation_source> m_cancellation_sources;
+        mutable detail::xevent_waiter* p_waiters;
+    };
+
+    /**********************
+     * xevent declaration *
+     **********************/
+
+    /**
+     * Event of a widget, such as a message from the front-end or the change
+     * of a property.
+     *
+     * Events are awaited by C++20 coroutines (see xcoroutine.hpp). Waiters
+     * are registered and resumed on the kernel thread, and are cancelled
+     * when the widget is destroyed.
+     */
+    class XWIDGETS_API xevent
+    {
+    public:
+
+        xevent(const xcommon& widget, std::string name);
+
+        const xcommon& widget() const noexcept;
+        const std::string& name() const noexcept;
+
+        void wait(detail::xevent_waiter& waiter) const;
+
+        static void cancel(detail::xevent_waiter& waiter);
+        static void detach(detail::xevent_waiter& waiter);
+
+    private:
+
+        const xcommon* p_widget;
+        std::string m_name;
+    };
+
+    /**
+     * Sends the throttled and debounced patches whose deadline has expired.
+     *
+     * This is called on the kernel thread each time a property is notified
+     * or a message is received from the front-end, and by flush. A timer
+     * also posts it to the kernel thread at each deadline, which runs it
+     * while the kernel is idle if a kernel wakeup is set (see
+     * set_kernel_wakeup), else with the next posted tasks.
+     */
+    XWIDGETS_API void process_sync_timers();
+
+    /**
+     * Enables or disables the deferred synchronization mode.
+     *
+     * In deferred mode, the patches of all widgets are held (last value
+     * wins per property) and sent as one update message per widget when
+     * flush is called. Patches are flushed at the end of each message
+     * received from the front-end, and before the first patch of a new
+     * kernel request. The first held patch also posts a flush to the
+     * kernel thread, which the kernel wakeup runs once the current request
+     * is done (see set_kernel_wakeup). Without a wakeup, patches held by
+     * an execute_request are only sent with the next request or message,
+     * unless the cell calls flush.
+     */
+    XWIDGETS_API void set_deferred_sync(bool deferred);
+    XWIDGETS_API bool deferred_sync();
+
+    /**
+     * Sends the patches held in deferred mode and the throttled or
+     * debounced patches that are due.
+     */
+    XWIDGETS_API void flush();
+
+    namespace detail
+    {
+        // Marks the handling of a message from the front-end on the kernel
+        // thread. The work triggered by the values of the message may be
+        // posted, to be run once by the flush ending the message.
+        class XWIDGETS_API xmessage_scope
+        {
+        public:
+
+            xmessage_scope() noexcept;
+            ~xmessage_scope();
+
+            xmessage_scope(const xmessage_scope&) = delete;
+            xmessage_scope& operator=(const xmessage_scope&) = delete;
+
+            static bool active() noexcept;
+        };
+    }
+
+    /*******************************
+     * hold_sync_guard declaration *
+     *******************************/
+
+    /**
+     * RAII transaction returned by xcommon::hold_sync.
+     *
+     * While a guard is alive, the patches sent by the widget are merged
+     * into a single pending patch (last write wins per property), which
+     * is sent as one update message when the outermost guard is
+     * destroyed.
+     */
+    class XWIDGETS_API hold_sync_guard
+    {
+    public:
+
+        explicit hold_sync_guard(xcommon& widget);
+        ~hold_sync_guard();
+
+        hold_sync_guard(const hold_sync_guard&) = delete;
+        hold_sync_guard& operator=(const hold_sync_guard&) = delete;
+
+        hold_sync_guard(hold_sync_guard&&);
+        hold_sync_guard& operator=(hold_sync_guard&&) = delete;
+
+    private:
+
+        xcommon* p_widget;
     };
 
     /**************************
      * to_json specialization *
-     *************************/
+     **************************/
 
     void XWIDGETS_API to_json(nl::json& j, const xcommon& o);
 
@@ -112,27 +350,7 @@ namespace xw
         nl::json state;
         xeus::buffer_sequence buffers;
         xwidgets_serialize(value, state[name], buffers);
-
-        if (m_hold != nullptr)
-        {
-            const auto& hold_state = m_hold->content()["data"]["state"];
-            const auto& hold_buffers = m_hold->buffers();
-
-            auto it = hold_state.find(name);
-            if (it != hold_state.end())
-            {
-                if(same_patch(name,
-                              *it,
-                              hold_buffers,
-                              state[name],
-                              buffers))
-                {
-                    return;
-                }
-            }
-        }
-
-        send_patch(std::move(state), std::move(buffers));
+        notify_patch(name, std::move(state), std::move(buffers));
     }
 }
 
@@ -35,7 +35,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(double, derived_type, value);
@@ -65,7 +64,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(double, derived_type, value);
@@ -97,7 +95,6 @@ namespace xw
         using xcontroller_axis_list_type = std::vector<xholder>;
         using xcontroller_button_list_type = std::vector<xholder>;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(int, derived_type, index);
@@ -126,15 +123,6 @@ namespace xw
      * xcontroller_button implementation *
      *************************************/
 
-    template <class D>
-    inline void xcontroller_button<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-        xwidgets_serialize(pressed(), state["pressed"], buffers);
-    }
-
     template <class D>
     inline void xcontroller_button<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -166,14 +154,6 @@ namespace xw
      * xcontroller_axis implementation *
      ***********************************/
 
-    template <class D>
-    inline void xcontroller_axis<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-    }
-
     template <class D>
     inline void xcontroller_axis<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -204,20 +184,6 @@ namespace xw
      * xcontroller implementation *
      ******************************/
 
-    template <class D>
-    inline void xcontroller<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(index(), state["index"], buffers);
-        xwidgets_serialize(name(), state["name"], buffers);
-        xwidgets_serialize(mapping(), state["mapping"], buffers);
-        xwidgets_serialize(connected(), state["connected"], buffers);
-        xwidgets_serialize(timestamp(), state["timestamp"], buffers);
-        xwidgets_serialize(buttons(), state["buttons"], buffers);
-        xwidgets_serialize(axes(), state["axes"], buffers);
-    }
-
     template <class D>
     inline void xcontroller<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
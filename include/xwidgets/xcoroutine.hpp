@@ -0,0 +1,386 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_COROUTINE_HPP
+#define XWIDGETS_COROUTINE_HPP
+
+// Coroutine support is only available to code compiled as C++20, the library
+// itself requiring C++14.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define XWIDGETS_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef XWIDGETS_HAS_COROUTINES
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "xcancellation.hpp"
+#include "xcommon.hpp"
+
+namespace xw
+{
+    /*********************
+     * xtask declaration *
+     *********************/
+
+    /**
+     * Coroutine run on the kernel thread, waiting for widget events.
+     *
+     * The coroutine starts when called, and runs until its first co_await.
+     * When the awaited event occurs, it is resumed by a task posted to the
+     * kernel thread, once the code raising the event, such as the observers
+     * of a property, has completed. Exceptions other than xcancelled
+     * propagate to the code running the posted tasks. Destroying the task
+     * destroys the coroutine, which stops waiting.
+     *
+     * @code{.cpp}
+     * xw::xtask count_clicks(xw::button& b, xw::label& l)
+     * {
+     *     for (int i = 1;; ++i)
+     *     {
+     *         co_await b.clicked();
+     *         l.value = std::to_string(i);
+     *     }
+     * }
+     * @endcode
+     */
+    class xtask
+    {
+    public:
+
+        struct promise_type
+        {
+            xtask get_return_object() noexcept;
+            std::suspend_never initial_suspend() const noexcept;
+            std::suspend_always final_suspend() const noexcept;
+            void return_void() const noexcept;
+            void unhandled_exception();
+
+            xtask* p_task = nullptr;
+            detail::xevent_waiter* p_waiter = nullptr;
+            bool m_suspended = false;
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        xtask() noexcept = default;
+        ~xtask();
+
+        xtask(const xtask&) = delete;
+        xtask& operator=(const xtask&) = delete;
+
+        xtask(xtask&&) noexcept;
+        xtask& operator=(xtask&&) noexcept;
+
+        bool done() const noexcept;
+        void cancel();
+
+    private:
+
+        explicit xtask(handle_type handle) noexcept;
+
+        handle_type m_handle = nullptr;
+    };
+
+    /******************************
+     * xevent_awaiter declaration *
+     ******************************/
+
+    namespace detail
+    {
+        class xevent_awaiter
+        {
+        public:
+
+            explicit xevent_awaiter(xevent event);
+            ~xevent_awaiter();
+
+            xevent_awaiter(const xevent_awaiter&) = delete;
+            xevent_awaiter& operator=(const xevent_awaiter&) = delete;
+
+            bool await_ready() const noexcept;
+            template <class P>
+            void await_suspend(std::coroutine_handle<P> handle);
+            void await_resume() const;
+
+        protected:
+
+            const xcommon& source() const noexcept;
+
+        private:
+
+            static void resume_waiter(xevent_waiter& waiter, bool cancelled);
+
+            xevent m_event;
+            xevent_waiter m_waiter;
+            std::coroutine_handle<> m_handle;
+            xevent_waiter** p_current;
+            bool m_cancelled;
+        };
+
+        template <class P>
+        class xproperty_awaiter : public xevent_awaiter
+        {
+        public:
+
+            using value_type = std::decay_t<decltype(std::declval<const P&>()())>;
+
+            xproperty_awaiter(xevent event, const P& property);
+
+            value_type await_resume() const;
+
+        private:
+
+            // Offset of the property in the widget, which may have moved
+            // by the time the coroutine is resumed
+            std::ptrdiff_t m_offset;
+        };
+
+        template <class P>
+        class xproperty_event
+        {
+        public:
+
+            xproperty_event(xevent event, const P& property);
+
+            xproperty_awaiter<P> operator co_await() const;
+
+        private:
+
+            xevent m_event;
+            const P* p_property;
+        };
+    }
+
+    /**
+     * Awaits an event of a widget, such as ``button.clicked()``.
+     */
+    detail::xevent_awaiter operator co_await(xevent event);
+
+    /**
+     * Returns the change of a property of a widget. Awaiting it returns the
+     * value of the property when the coroutine is resumed, which is the
+     * last one assigned before the resumption.
+     *
+     * @code{.cpp}
+     * double value = co_await xw::changed(slider.value);
+     * @endcode
+     */
+    template <class P>
+    detail::xproperty_event<P> changed(const P& property);
+
+    /************************
+     * xtask implementation *
+     ************************/
+
+    inline xtask xtask::promise_type::get_return_object() noexcept
+    {
+        return xtask(handle_type::from_promise(*this));
+    }
+
+    inline std::suspend_never xtask::promise_type::initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    inline std::suspend_always xtask::promise_type::final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    inline void xtask::promise_type::return_void() const noexcept
+    {
+    }
+
+    inline void xtask::promise_type::unhandled_exception()
+    {
+        try
+        {
+            throw;
+        }
+        catch (const xcancelled&)
+        {
+        }
+        catch (...)
+        {
+            // Before the first suspension, the exception leaves the call of
+            // the coroutine, which destroys its frame.
+            if (!m_suspended && p_task != nullptr)
+            {
+                p_task->m_handle = nullptr;
+            }
+            throw;
+        }
+    }
+
+    inline xtask::xtask(handle_type handle) noexcept
+        : m_handle(handle)
+    {
+        m_handle.promise().p_task = this;
+    }
+
+    inline xtask::~xtask()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    inline xtask::xtask(xtask&& rhs) noexcept
+        : m_handle(std::exchange(rhs.m_handle, nullptr))
+    {
+        if (m_handle)
+        {
+            m_handle.promise().p_task = this;
+        }
+    }
+
+    inline xtask& xtask::operator=(xtask&& rhs) noexcept
+    {
+        std::swap(m_handle, rhs.m_handle);
+        if (m_handle)
+        {
+            m_handle.promise().p_task = this;
+        }
+        if (rhs.m_handle)
+        {
+            rhs.m_handle.promise().p_task = &rhs;
+        }
+        return *this;
+    }
+
+    inline bool xtask::done() const noexcept
+    {
+        return !m_handle || m_handle.done();
+    }
+
+    inline void xtask::cancel()
+    {
+        if (m_handle && !m_handle.done() && m_handle.promise().p_waiter != nullptr)
+        {
+            xevent::cancel(*m_handle.promise().p_waiter);
+        }
+    }
+
+    /*********************************
+     * xevent_awaiter implementation *
+     *********************************/
+
+    namespace detail
+    {
+        inline xevent_awaiter::xevent_awaiter(xevent event)
+            : m_event(std::move(event)), p_current(nullptr), m_cancelled(false)
+        {
+        }
+
+        inline xevent_awaiter::~xevent_awaiter()
+        {
+            // The coroutine is destroyed while waiting
+            xevent::detach(m_waiter);
+            if (p_current != nullptr)
+            {
+                *p_current = nullptr;
+            }
+        }
+
+        inline bool xevent_awaiter::await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <class P>
+        inline void xevent_awaiter::await_suspend(std::coroutine_handle<P> handle)
+        {
+            m_handle = handle;
+            m_waiter.resume = &xevent_awaiter::resume_waiter;
+            m_waiter.context = this;
+            m_event.wait(m_waiter);
+            if constexpr (std::is_same<P, xtask::promise_type>::value)
+            {
+                handle.promise().m_suspended = true;
+                p_current = &handle.promise().p_waiter;
+                *p_current = &m_waiter;
+            }
+        }
+
+        inline void xevent_awaiter::await_resume() const
+        {
+            if (m_cancelled)
+            {
+                throw xcancelled();
+            }
+        }
+
+        inline const xcommon& xevent_awaiter::source() const noexcept
+        {
+            return *m_waiter.source;
+        }
+
+        inline void xevent_awaiter::resume_waiter(xevent_waiter& waiter, bool cancelled)
+        {
+            auto& self = *static_cast<xevent_awaiter*>(waiter.context);
+            self.m_cancelled = cancelled;
+            if (self.p_current != nullptr)
+            {
+                *self.p_current = nullptr;
+                self.p_current = nullptr;
+            }
+            self.m_handle.resume();
+        }
+
+        template <class P>
+        inline xproperty_awaiter<P>::xproperty_awaiter(xevent event, const P& property)
+            : xevent_awaiter(std::move(event)),
+              m_offset(reinterpret_cast<const char*>(std::addressof(property))
+                       - reinterpret_cast<const char*>(static_cast<const xcommon*>(property.owner())))
+        {
+        }
+
+        template <class P>
+        inline auto xproperty_awaiter<P>::await_resume() const -> value_type
+        {
+            xevent_awaiter::await_resume();
+            const char* widget = reinterpret_cast<const char*>(std::addressof(this->source()));
+            return (*reinterpret_cast<const P*>(widget + m_offset))();
+        }
+
+        template <class P>
+        inline xproperty_event<P>::xproperty_event(xevent event, const P& property)
+            : m_event(std::move(event)), p_property(&property)
+        {
+        }
+
+        template <class P>
+        inline xproperty_awaiter<P> xproperty_event<P>::operator co_await() const
+        {
+            return xproperty_awaiter<P>(m_event, *p_property);
+        }
+    }
+
+    inline detail::xevent_awaiter operator co_await(xevent event)
+    {
+        return detail::xevent_awaiter(std::move(event));
+    }
+
+    template <class P>
+    inline detail::xproperty_event<P> changed(const P& property)
+    {
+        return detail::xproperty_event<P>(xevent(*property.owner(), property.name()), property);
+    }
+}
+
+#endif
+
+#endif
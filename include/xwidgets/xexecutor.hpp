@@ -0,0 +1,150 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_EXECUTOR_HPP
+#define XWIDGETS_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xeus/xguid.hpp"
+
+#include "xwidgets_config.hpp"
+
+namespace xw
+{
+    /*************************
+     * xexecutor declaration *
+     *************************/
+
+    /**
+     * Pool of worker threads running the callbacks of widgets.
+     *
+     * Each worker has its own queue. Tasks submitted from a worker are
+     * pushed on its queue, other tasks are distributed in turn. A worker
+     * runs the last task of its queue, and steals the first task of the
+     * other queues when its own is empty.
+     *
+     * Tasks may stop by throwing xcancelled. They must not throw other
+     * exceptions.
+     */
+    class XWIDGETS_API xexecutor
+    {
+    public:
+
+        using task_type = std::function<void()>;
+
+        explicit xexecutor(std::size_t thread_count);
+        ~xexecutor();
+
+        xexecutor(const xexecutor&) = delete;
+        xexecutor& operator=(const xexecutor&) = delete;
+
+        void submit(task_type task);
+        std::size_t size() const noexcept;
+
+    private:
+
+        struct worker_queue
+        {
+            std::mutex mutex;
+            std::deque<task_type> tasks;
+        };
+
+        void run(std::size_t index);
+        bool pop(std::size_t index, task_type& task);
+
+        std::vector<std::unique_ptr<worker_queue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::atomic<std::size_t> m_next;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::size_t m_pending;
+        bool m_stop;
+    };
+
+    /**
+     * Executor of the asynchronous callbacks, with one worker per hardware
+     * thread.
+     */
+    XWIDGETS_API xexecutor& get_callback_executor();
+
+    /************************************
+     * xcallback_dispatcher declaration *
+     ************************************/
+
+    /**
+     * How the callbacks of a widget event are run.
+     *
+     * - synchronous: on the kernel thread, when the event is received
+     *   (default).
+     * - serialize: on the executor, one event at a time, in order.
+     * - drop_while_busy: on the executor, events received while the
+     *   callbacks of a former event run being dropped.
+     * - run_latest: on the executor, only the latest of the events received
+     *   while the callbacks of a former event run being kept.
+     *
+     * Asynchronous callbacks update widgets with post. The posted updates,
+     * and the errors of the callbacks, are delivered on the kernel thread
+     * like other posted tasks: by the kernel wakeup, or otherwise by the
+     * next message from the front-end or call to process_posted_tasks.
+     */
+    enum class xcallback_mode
+    {
+        synchronous,
+        serialize,
+        drop_while_busy,
+        run_latest
+    };
+
+    class XWIDGETS_API xcallback_dispatcher
+    {
+    public:
+
+        using task_type = std::function<void()>;
+        using error_handler_type = std::function<void(std::exception_ptr)>;
+
+        xcallback_dispatcher();
+        ~xcallback_dispatcher() = default;
+
+        // Copies have their own queue
+        xcallback_dispatcher(const xcallback_dispatcher&);
+        xcallback_dispatcher& operator=(const xcallback_dispatcher&);
+
+        xcallback_dispatcher(xcallback_dispatcher&&);
+        xcallback_dispatcher& operator=(xcallback_dispatcher&&);
+
+        xcallback_mode mode() const;
+        void set_mode(xcallback_mode mode);
+
+        // Called on the kernel thread with the exceptions thrown by the
+        // asynchronous callbacks, if the widget is still alive. They are
+        // logged to std::cerr otherwise, and by default.
+        void set_error_handler(error_handler_type handler);
+
+        void dispatch(const xeus::xguid& id, task_type task);
+
+    private:
+
+        struct state;
+
+        static void run(std::shared_ptr<state> s, xeus::xguid id, task_type task);
+
+        std::shared_ptr<state> p_state;
+    };
+}
+
+#endif
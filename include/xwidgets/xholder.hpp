@@ -9,12 +9,19 @@
 #ifndef XWIDGETS_HOLDER_HPP
 #define XWIDGETS_HOLDER_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "xeus/xguid.hpp"
+#include "xeus/xmessage.hpp"
 
 #include "nlohmann/json.hpp"
 
@@ -30,6 +37,18 @@ namespace xw
     namespace detail
     {
         class xholder_impl;
+
+        // Large enough for the id, weak and shared holders
+        constexpr std::size_t holder_buffer_size = 10 * sizeof(void*);
+        using holder_buffer_type = std::aligned_storage_t<holder_buffer_size, alignof(std::max_align_t)>;
+
+        template <class I>
+        struct fits_holder_buffer
+            : std::integral_constant<bool, sizeof(I) <= holder_buffer_size && alignof(I) <= alignof(holder_buffer_type)>
+        {
+        };
+
+        constexpr std::uint32_t unresolved_handle = static_cast<std::uint32_t>(-1);
     }
 
     template <class D>
@@ -39,6 +58,14 @@ namespace xw
      * xholder declaration *
      ***********************/
 
+    /**
+     * Type-erased widget, holding an implementation that refers to the
+     * widget by id, by pointer, or owns it.
+     *
+     * Implementations that fit in a small buffer are stored inline, so that
+     * copying a list of id holders, such as the children of a box, does not
+     * allocate. Owning holders are allocated from a pool per widget type.
+     */
     class XWIDGETS_API xholder
     {
     public:
@@ -70,8 +97,12 @@ namespace xw
 
         void swap(xholder& rhs);
 
+        template <class I, class... Args>
+        void emplace(Args&&... args);
+
         void display() const;
         xeus::xguid id() const;
+        void serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const;
 
         xtl::any value() &;
         const xtl::any value() const &;
@@ -85,6 +116,12 @@ namespace xw
 
         void check_holder() const;
 
+        bool is_inline() const noexcept;
+        void move_from(xholder& rhs) noexcept;
+        void reset() noexcept;
+
+        // p_holder points either to m_buffer or to the heap
+        detail::holder_buffer_type m_buffer;
         implementation_type* p_holder;
     };
 
@@ -125,19 +162,37 @@ namespace xw
 
     namespace detail
     {
+        class xholder_impl;
+
+        // Holder of the widget id in the transport registry, or nullptr if
+        // it is not registered. The handle and the generation of the entry
+        // are stored in handle and generation.
+        XWIDGETS_API xholder* find_registered(const xeus::xguid& id, std::uint32_t& handle, std::uint32_t& generation);
+
+        // Whether the entry of handle has kept its generation, that is, the
+        // widget has neither been moved nor unregistered.
+        XWIDGETS_API bool same_registration(std::uint32_t handle, std::uint32_t generation) noexcept;
+
         class xholder_impl
         {
         public:
 
             xholder_impl() = default;
-            xholder_impl(xholder_impl&&) = delete;
             xholder_impl& operator=(const xholder_impl&) = delete;
             xholder_impl& operator=(xholder_impl&&) = delete;
-            virtual xholder_impl* clone() const = 0;
             virtual ~xholder_impl() = default;
 
+            // Copies the holder into buffer, the small buffer of the target
+            // xholder, when it fits there, or on the heap.
+            virtual xholder_impl* clone(void* buffer) const = 0;
+            // Moves a holder stored in a small buffer into buffer. Holders
+            // that do not fit there are moved by pointer, and do not
+            // override it.
+            virtual xholder_impl* move(void* buffer) noexcept;
+
             virtual void display() const = 0;
             virtual xeus::xguid id() const = 0;
+            virtual void serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const = 0;
 
             virtual xtl::any value() & = 0;
             virtual const xtl::any value() const & = 0;
@@ -145,8 +200,148 @@ namespace xw
         protected:
 
             xholder_impl(const xholder_impl&) = default;
+            xholder_impl(xholder_impl&&) = default;
+        };
+
+        inline xholder_impl* xholder_impl::move(void*) noexcept
+        {
+            std::terminate();
+        }
+
+        template <class I, class... Args>
+        inline xholder_impl* construct_holder(std::true_type, void* buffer, Args&&... args)
+        {
+            return ::new (buffer) I(std::forward<Args>(args)...);
+        }
+
+        template <class I, class... Args>
+        inline xholder_impl* construct_holder(std::false_type, void*, Args&&... args)
+        {
+            return new I(std::forward<Args>(args)...);
+        }
+
+        /****************
+         * xholder_pool *
+         ****************/
+
+        /**
+         * Storage of the holders of type T. Blocks are carved out of chunks
+         * and released blocks are kept in a free list for later holders of
+         * the same type. The free list is shared by all threads, so that
+         * blocks released by another thread than the one which allocated
+         * them are reused. It is guarded by a spin lock, and trivially
+         * destructible so that holders destroyed along with static objects
+         * can still release their block.
+         */
+        template <class T>
+        class xholder_pool
+        {
+        public:
+
+            static void* allocate(std::size_t size);
+            static void deallocate(void* block, std::size_t size) noexcept;
+
+        private:
+
+            union node
+            {
+                node* next;
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            };
+
+            static constexpr std::size_t chunk_size = 32;
+
+            struct free_list_type
+            {
+                std::atomic_flag locked;
+                node* head;
+            };
+
+            class lock_guard
+            {
+            public:
+
+                explicit lock_guard(std::atomic_flag& flag) noexcept;
+                ~lock_guard();
+
+                lock_guard(const lock_guard&) = delete;
+                lock_guard& operator=(const lock_guard&) = delete;
+
+            private:
+
+                std::atomic_flag& m_flag;
+            };
+
+            static free_list_type& free_list() noexcept;
         };
 
+        template <class T>
+        inline void* xholder_pool<T>::allocate(std::size_t size)
+        {
+            if (size != sizeof(T))
+            {
+                return ::operator new(size);
+            }
+            free_list_type& list = free_list();
+            {
+                lock_guard guard(list.locked);
+                if (list.head != nullptr)
+                {
+                    node* res = list.head;
+                    list.head = res->next;
+                    return res;
+                }
+            }
+
+            // The chunk is allocated and linked outside of the lock
+            node* chunk = static_cast<node*>(::operator new(chunk_size * sizeof(node)));
+            for (std::size_t i = 1; i + 1 < chunk_size; ++i)
+            {
+                chunk[i].next = &chunk[i + 1];
+            }
+            lock_guard guard(list.locked);
+            chunk[chunk_size - 1].next = list.head;
+            list.head = &chunk[1];
+            return &chunk[0];
+        }
+
+        template <class T>
+        inline void xholder_pool<T>::deallocate(void* block, std::size_t size) noexcept
+        {
+            if (size != sizeof(T))
+            {
+                ::operator delete(block);
+                return;
+            }
+            free_list_type& list = free_list();
+            node* released = static_cast<node*>(block);
+            lock_guard guard(list.locked);
+            released->next = list.head;
+            list.head = released;
+        }
+
+        template <class T>
+        inline auto xholder_pool<T>::free_list() noexcept -> free_list_type&
+        {
+            static free_list_type list = { ATOMIC_FLAG_INIT, nullptr };
+            return list;
+        }
+
+        template <class T>
+        inline xholder_pool<T>::lock_guard::lock_guard(std::atomic_flag& flag) noexcept
+            : m_flag(flag)
+        {
+            while (m_flag.test_and_set(std::memory_order_acquire))
+            {
+            }
+        }
+
+        template <class T>
+        inline xholder_pool<T>::lock_guard::~lock_guard()
+        {
+            m_flag.clear(std::memory_order_release);
+        }
+
         template <class D>
         class xholder_owning : public xholder_impl
         {
@@ -168,10 +363,23 @@ namespace xw
 
             virtual ~xholder_owning()
             {
+                static_assert(!fits_holder_buffer<xholder_owning>::value,
+                              "owning holders are allocated from the pool and moved by pointer");
             }
 
-            virtual base_type* clone() const override
+            static void* operator new(std::size_t size)
             {
+                return xholder_pool<xholder_owning>::allocate(size);
+            }
+
+            static void operator delete(void* block, std::size_t size) noexcept
+            {
+                xholder_pool<xholder_owning>::deallocate(block, size);
+            }
+
+            virtual base_type* clone(void*) const override
+            {
+                // Widgets are too large for the small buffer
                 return new xholder_owning(*this);
             }
 
@@ -185,6 +393,11 @@ namespace xw
                 return m_value.id();
             }
 
+            virtual void serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const override
+            {
+                m_value.serialize_state(state, buffers);
+            }
+
             virtual xtl::any value() & override
             {
                 return xtl::closure(m_value);
@@ -214,7 +427,10 @@ namespace xw
 
             xholder_weak(xtransport<D>* ptr)
                 : base_type(),
-                  p_value(&(ptr->derived_cast()))
+                  p_value(&(ptr->derived_cast())),
+                  m_id(ptr->id()),
+                  m_handle(unresolved_handle),
+                  m_generation(0)
             {
             }
 
@@ -223,29 +439,43 @@ namespace xw
                 p_value = nullptr;
             }
 
-            virtual base_type* clone() const override
+            virtual base_type* clone(void* buffer) const override
             {
+                if (fits_holder_buffer<xholder_weak>::value)
+                {
+                    return ::new (buffer) xholder_weak(*this);
+                }
                 return new xholder_weak(*this);
             }
 
+            virtual base_type* move(void* buffer) noexcept override
+            {
+                return ::new (buffer) xholder_weak(std::move(*this));
+            }
+
             virtual void display() const override
             {
-                p_value->display();
+                resolve().display();
             }
 
             virtual xeus::xguid id() const override
             {
-                return p_value->id();
+                return m_id;
+            }
+
+            virtual void serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const override
+            {
+                resolve().serialize_state(state, buffers);
             }
 
             virtual xtl::any value() & override
             {
-                return xtl::closure(*p_value);
+                return xtl::closure(resolve());
             }
 
             virtual const xtl::any value() const & override
             {
-                return xtl::closure(*p_value);
+                return xtl::closure(static_cast<const D&>(resolve()));
             }
 
         private:
@@ -255,7 +485,27 @@ namespace xw
             xholder_weak& operator=(const xholder_weak&) = default;
             xholder_weak& operator=(xholder_weak&&) = default;
 
-            D* p_value;
+            D& resolve() const
+            {
+                // A copy of the holder outlives the moves and the destruction
+                // of the widget, whose current address is the one of the
+                // registry. The registry holder resolves to itself.
+                if (m_handle == unresolved_handle || !same_registration(m_handle, m_generation))
+                {
+                    xholder* holder = find_registered(m_id, m_handle, m_generation);
+                    if (holder == nullptr)
+                    {
+                        throw std::runtime_error("Widget " + std::string(m_id) + " has been destroyed");
+                    }
+                    p_value = &(holder->template get<D>());
+                }
+                return *p_value;
+            }
+
+            mutable D* p_value;
+            xeus::xguid m_id;
+            mutable std::uint32_t m_handle;
+            mutable std::uint32_t m_generation;
         };
 
         template <class D>
@@ -279,11 +529,21 @@ namespace xw
             }
 
             virtual ~xholder_shared() = default;
-            virtual base_type* clone() const override
+
+            virtual base_type* clone(void* buffer) const override
             {
+                if (fits_holder_buffer<xholder_shared>::value)
+                {
+                    return ::new (buffer) xholder_shared(*this);
+                }
                 return new xholder_shared(*this);
             }
 
+            virtual base_type* move(void* buffer) noexcept override
+            {
+                return ::new (buffer) xholder_shared(std::move(*this));
+            }
+
             virtual void display() const override
             {
                 p_value->display();
@@ -294,6 +554,11 @@ namespace xw
                 return p_value->id();
             }
 
+            virtual void serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const override
+            {
+                p_value->serialize_state(state, buffers);
+            }
+
             virtual xtl::any value() & override
             {
                 return xtl::closure(*p_value);
@@ -313,19 +578,25 @@ namespace xw
     template <class D>
     xholder make_weak_holder(xtransport<D>* ptr)
     {
-        return xholder(new detail::xholder_weak<D>(ptr));
+        xholder res;
+        res.template emplace<detail::xholder_weak<D>>(ptr);
+        return res;
     }
 
     template <class D>
     xholder make_owning_holder(xtransport<D>&& value)
     {
-        return xholder(new detail::xholder_owning<D>(std::move(value)));
+        xholder res;
+        res.template emplace<detail::xholder_owning<D>>(std::move(value));
+        return res;
     }
 
     template <class D>
     inline xholder make_shared_holder(std::shared_ptr<xtransport<D>> ptr)
     {
-        return xholder(new detail::xholder_shared<D>(std::static_pointer_cast<D>(ptr)));
+        xholder res;
+        res.template emplace<detail::xholder_shared<D>>(std::static_pointer_cast<D>(ptr));
+        return res;
     }
 
     /*******************************************
@@ -378,6 +649,14 @@ namespace xw
         return *this;
     }
 
+    template <class I, class... Args>
+    inline void xholder::emplace(Args&&... args)
+    {
+        // The former implementation is destroyed last, as with assignments
+        xholder former(std::move(*this));
+        p_holder = detail::construct_holder<I>(detail::fits_holder_buffer<I>(), &m_buffer, std::forward<Args>(args)...);
+    }
+
     template <class D>
     D& xholder::get() &
     {
@@ -30,7 +30,6 @@ namespace xw
         using base_type = xmedia<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json& state, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, format, "png");
@@ -53,16 +52,6 @@ namespace xw
      * ximage implementation *
      *************************/
 
-    template <class D>
-    inline void ximage<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(format(), state["format"], buffers);
-        xwidgets_serialize(width(), state["width"], buffers);
-        xwidgets_serialize(height(), state["height"], buffers);
-    }
-
     template <class D>
     inline void ximage<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -98,25 +87,6 @@ namespace xw
         return image::initialize().value(value).format("url");
     }
 
-    /**********************
-     * custom serializers *
-     **********************/
-
-    inline void set_property_from_patch(decltype(image::value)& property,
-                                        const nl::json& patch,
-                                        const xeus::buffer_sequence& buffers)
-    {
-        auto it = patch.find(property.name());
-        if (it != patch.end())
-        {
-            using value_type = typename decltype(image::value)::value_type;
-            std::size_t index = buffer_index(patch[property.name()].template get<std::string>());
-            const auto& value_buffer = buffers[index];
-            const char* value_buf = value_buffer.data<const char>();
-            property = value_type(value_buf, value_buf + value_buffer.size());
-        }
-    }
-
     /*********************
      * precompiled types *
      *********************/
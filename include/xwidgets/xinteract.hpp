@@ -0,0 +1,444 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_INTERACT_HPP
+#define XWIDGETS_INTERACT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xbox.hpp"
+#include "xcheckbox.hpp"
+#include "xdropdown.hpp"
+#include "xoutput.hpp"
+#include "xpost.hpp"
+#include "xslider.hpp"
+
+namespace xw
+{
+    /****************************
+     * xinteractive declaration *
+     ****************************/
+
+    namespace detail
+    {
+        // Control built for an argument of interact. Widgets are used as
+        // they are, other arguments are abbreviations.
+        template <class T, class = void>
+        struct xinteract_control
+        {
+            using type = std::decay_t<T>;
+
+            template <class U>
+            static type make(U&& widget)
+            {
+                return std::forward<U>(widget);
+            }
+        };
+
+        // true or false: checkbox
+        template <>
+        struct xinteract_control<bool>
+        {
+            using type = checkbox;
+
+            static type make(bool value)
+            {
+                return checkbox::initialize().value(value).finalize();
+            }
+        };
+
+        // Options: dropdown, on the first option
+        template <>
+        struct xinteract_control<std::vector<std::string>>
+        {
+            using type = dropdown;
+
+            static type make(std::vector<std::string> options)
+            {
+                std::string value = options.empty() ? std::string() : options.front();
+                return dropdown(std::move(options), std::move(value));
+            }
+        };
+
+        // Step of a (min, max) range: 1 for integers, a hundredth of the
+        // range for floating-point numbers, like ipywidgets
+        template <class T>
+        inline T xinteract_step(const T&, const T&, std::false_type)
+        {
+            return T(1);
+        }
+
+        template <class T>
+        inline T xinteract_step(const T& min, const T& max, std::true_type)
+        {
+            return (max - min) / T(100);
+        }
+
+        // (min, max) or (min, max, step): slider, in the middle of the range
+        template <class T>
+        struct xinteract_control<std::pair<T, T>, std::enable_if_t<std::is_arithmetic<T>::value>>
+        {
+            using type = slider<T>;
+
+            static type make(const std::pair<T, T>& range)
+            {
+                T step = xinteract_step(range.first, range.second, std::is_floating_point<T>());
+                return xinteract_control<std::tuple<T, T, T>>::make(std::make_tuple(range.first, range.second, step));
+            }
+        };
+
+        template <class T>
+        struct xinteract_control<std::tuple<T, T, T>, std::enable_if_t<std::is_arithmetic<T>::value>>
+        {
+            using type = slider<T>;
+
+            static type make(const std::tuple<T, T, T>& range)
+            {
+                const T& min = std::get<0>(range);
+                const T& max = std::get<1>(range);
+                return slider<T>::initialize()
+                    .min(min)
+                    .max(max)
+                    .step(std::get<2>(range))
+                    .value(T(min + (max - min) / 2))
+                    .finalize();
+            }
+        };
+
+        template <class T>
+        using xinteract_control_t = typename xinteract_control<std::decay_t<T>>::type;
+
+        template <class C>
+        using xinteract_value_t = std::decay_t<decltype(std::declval<const C&>().value())>;
+
+        // Display data of a result, its mime bundle when it has one, else
+        // its text representation.
+        template <class R>
+        inline auto xinteract_mime_bundle(const R& result, int) -> decltype(mime_bundle_repr(result))
+        {
+            return mime_bundle_repr(result);
+        }
+
+        template <class R>
+        inline nl::json xinteract_mime_bundle(const R& result, long)
+        {
+            std::ostringstream oss;
+            oss << result;
+            nl::json bundle;
+            bundle["text/plain"] = oss.str();
+            return bundle;
+        }
+    }
+
+    /**
+     * Controls bound to a function, whose result is displayed in an output
+     * widget below them. See interact.
+     */
+    template <class F, class... C>
+    class xinteractive
+    {
+    public:
+
+        using function_type = F;
+        using controls_type = std::tuple<C...>;
+        using key_type = std::tuple<detail::xinteract_value_t<C>...>;
+        using result_type = std::decay_t<decltype(std::declval<F&>()(std::declval<const detail::xinteract_value_t<C>&>()...))>;
+        using duration_type = std::chrono::steady_clock::duration;
+
+        static_assert(!std::is_void<result_type>::value, "interact requires a function returning the value to display");
+
+        template <class G, class... W>
+        xinteractive(G&& fn, W&&... controls);
+
+        template <std::size_t I>
+        std::tuple_element_t<I, controls_type>& control() noexcept;
+        output& out() noexcept;
+        vbox& widget() noexcept;
+        const vbox& widget() const noexcept;
+
+        void display() const;
+        void update();
+
+        std::size_t cache_capacity() const noexcept;
+        void set_cache_capacity(std::size_t capacity);
+        std::size_t computations() const noexcept;
+
+        duration_type debounce() const noexcept;
+        void set_debounce(duration_type interval);
+
+    private:
+
+        // Most recently used results last
+        using cache_list = std::list<std::pair<key_type, result_type>>;
+
+        // Heap-allocated, so that the observers of the controls can refer to
+        // it when the xinteractive is moved.
+        struct state
+        {
+            template <class G, class... W>
+            state(G&& fn, W&&... controls);
+
+            template <std::size_t... I>
+            void observe_controls(std::index_sequence<I...>);
+            template <std::size_t... I>
+            key_type make_key(std::index_sequence<I...>) const;
+            template <std::size_t... I>
+            result_type compute(const key_type& key, std::index_sequence<I...>);
+
+            void update();
+            void changed();
+            void evict();
+
+            F m_function;
+            controls_type m_controls;
+            output m_out;
+            vbox m_box;
+            cache_list m_cache;
+            std::map<key_type, typename cache_list::iterator> m_index;
+            std::size_t m_capacity;
+            std::size_t m_computations;
+            duration_type m_debounce;
+            const result_type* p_shown;
+        };
+
+        std::unique_ptr<state> p_state;
+    };
+
+    /**
+     * Builds controls for the arguments of fn, and displays the result of fn
+     * for their current values in an output widget.
+     *
+     * Controls are given as widgets having a value, or as abbreviations:
+     * a bool gives a checkbox, a vector of strings a dropdown, and a pair
+     * (min, max) or a tuple (min, max, step) of numbers a slider.
+     *
+     * Results are kept in a cache of the latest argument values, so that
+     * going back to former values shows their result at once. Other values
+     * are debounced: the result is computed once the arguments have not
+     * changed for the debounce interval (100 ms by default, see
+     * set_debounce), so that dragging a slider computes the result of the
+     * value it stops at. With an interval of zero, the result is computed
+     * at once, and the changes made by one message from the front-end lead
+     * to one computation at the end of the message.
+     */
+    template <class F, class... W>
+    xinteractive<std::decay_t<F>, detail::xinteract_control_t<W>...> interact(F&& fn, W&&... controls);
+
+    template <class F, class... C>
+    nl::json mime_bundle_repr(const xinteractive<F, C...>& interactive);
+
+    /*******************************
+     * xinteractive implementation *
+     *******************************/
+
+    template <class F, class... C>
+    template <class G, class... W>
+    inline xinteractive<F, C...>::state::state(G&& fn, W&&... controls)
+        : m_function(std::forward<G>(fn)),
+          m_controls(detail::xinteract_control<std::decay_t<W>>::make(std::forward<W>(controls))...),
+          m_capacity(128),
+          m_computations(0),
+          m_debounce(std::chrono::milliseconds(100)),
+          p_shown(nullptr)
+    {
+        observe_controls(std::index_sequence_for<C...>());
+        m_box.add(m_out);
+        update();
+    }
+
+    template <class F, class... C>
+    template <std::size_t... I>
+    inline void xinteractive<F, C...>::state::observe_controls(std::index_sequence<I...>)
+    {
+        auto observe = [this](auto& control) {
+            m_box.add(control);
+            control.observe("value", [this](const auto&) { changed(); });
+        };
+        (void)observe;
+        using expander = int[];
+        (void)expander{0, (observe(std::get<I>(m_controls)), 0)...};
+    }
+
+    template <class F, class... C>
+    template <std::size_t... I>
+    inline auto xinteractive<F, C...>::state::make_key(std::index_sequence<I...>) const -> key_type
+    {
+        return key_type(std::get<I>(m_controls).value()...);
+    }
+
+    template <class F, class... C>
+    template <std::size_t... I>
+    inline auto xinteractive<F, C...>::state::compute(const key_type& key, std::index_sequence<I...>) -> result_type
+    {
+        ++m_computations;
+        return m_function(std::get<I>(key)...);
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::state::update()
+    {
+        key_type key = make_key(std::index_sequence_for<C...>());
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            m_cache.splice(m_cache.end(), m_cache, it->second);
+        }
+        else
+        {
+            result_type result = compute(key, std::index_sequence_for<C...>());
+            m_cache.emplace_back(key, std::move(result));
+            m_index.emplace(std::move(key), std::prev(m_cache.end()));
+            evict();
+        }
+
+        const result_type& result = m_cache.back().second;
+        if (&result != p_shown)
+        {
+            nl::json entry;
+            entry["output_type"] = "display_data";
+            entry["data"] = detail::xinteract_mime_bundle(result, 0);
+            entry["metadata"] = nl::json::object();
+            m_out.outputs = std::vector<nl::json>({std::move(entry)});
+            p_shown = &result;
+        }
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::state::changed()
+    {
+        // Arguments whose result is not cached wait for the end of the
+        // debounce interval, each change postponing the update. The update
+        // uses the values of the controls at that time.
+        if (m_debounce != duration_type::zero()
+            && m_index.find(make_key(std::index_sequence_for<C...>())) == m_index.end())
+        {
+            detail::post_task_at(std::chrono::steady_clock::now() + m_debounce, m_out.id(), "interact", [this](xholder&) {
+                update();
+            });
+            return;
+        }
+        if (!detail::xmessage_scope::active())
+        {
+            update();
+            return;
+        }
+        // The values of a message, such as the value and the index of a
+        // dropdown, lead to one update at the end of the message.
+        detail::post_task(m_out.id(), "interact", [this](xholder&) { update(); });
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::state::evict()
+    {
+        // The result shown, the most recently used, is kept
+        while (m_cache.size() > m_capacity && m_cache.size() > 1)
+        {
+            m_index.erase(m_cache.front().first);
+            m_cache.pop_front();
+        }
+    }
+
+    template <class F, class... C>
+    template <class G, class... W>
+    inline xinteractive<F, C...>::xinteractive(G&& fn, W&&... controls)
+        : p_state(new state(std::forward<G>(fn), std::forward<W>(controls)...))
+    {
+    }
+
+    template <class F, class... C>
+    template <std::size_t I>
+    inline auto xinteractive<F, C...>::control() noexcept -> std::tuple_element_t<I, controls_type>&
+    {
+        return std::get<I>(p_state->m_controls);
+    }
+
+    template <class F, class... C>
+    inline output& xinteractive<F, C...>::out() noexcept
+    {
+        return p_state->m_out;
+    }
+
+    template <class F, class... C>
+    inline vbox& xinteractive<F, C...>::widget() noexcept
+    {
+        return p_state->m_box;
+    }
+
+    template <class F, class... C>
+    inline const vbox& xinteractive<F, C...>::widget() const noexcept
+    {
+        return p_state->m_box;
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::display() const
+    {
+        p_state->m_box.display();
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::update()
+    {
+        p_state->update();
+    }
+
+    template <class F, class... C>
+    inline std::size_t xinteractive<F, C...>::cache_capacity() const noexcept
+    {
+        return p_state->m_capacity;
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::set_cache_capacity(std::size_t capacity)
+    {
+        p_state->m_capacity = capacity;
+        p_state->evict();
+    }
+
+    template <class F, class... C>
+    inline std::size_t xinteractive<F, C...>::computations() const noexcept
+    {
+        return p_state->m_computations;
+    }
+
+    template <class F, class... C>
+    inline auto xinteractive<F, C...>::debounce() const noexcept -> duration_type
+    {
+        return p_state->m_debounce;
+    }
+
+    template <class F, class... C>
+    inline void xinteractive<F, C...>::set_debounce(duration_type interval)
+    {
+        p_state->m_debounce = interval;
+    }
+
+    template <class F, class... W>
+    inline xinteractive<std::decay_t<F>, detail::xinteract_control_t<W>...> interact(F&& fn, W&&... controls)
+    {
+        return xinteractive<std::decay_t<F>, detail::xinteract_control_t<W>...>(std::forward<F>(fn), std::forward<W>(controls)...);
+    }
+
+    template <class F, class... C>
+    inline nl::json mime_bundle_repr(const xinteractive<F, C...>& interactive)
+    {
+        return mime_bundle_repr(interactive.widget());
+    }
+}
+
+#endif
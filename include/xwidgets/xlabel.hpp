@@ -26,7 +26,6 @@ namespace xw
         using base_type = xstring<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
     protected:
@@ -45,12 +44,6 @@ namespace xw
      * xlabel implementation *
      *************************/
 
-    template <class D>
-    inline void xlabel<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-    }
-
     template <class D>
     inline void xlabel<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -29,7 +29,6 @@ namespace xw
         using base_type = xobject<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(xtl::xoptional<std::string>, derived_type, align_content, {}, XEITHER_OPTIONAL("flex-start", "flex-end", "center", "space-between", "space-around", "space-evenly", "stretch", "inherit", "inital", "unset"));
@@ -75,37 +74,6 @@ namespace xw
      * layout implementation *
      *************************/
 
-    template <class D>
-    inline void xlayout<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(align_content(), state["align_content"], buffers);
-        xwidgets_serialize(align_items(), state["align_items"], buffers);
-        xwidgets_serialize(align_self(), state["align_self"], buffers);
-        xwidgets_serialize(bottom(), state["bottom"], buffers);
-        xwidgets_serialize(border(), state["border"], buffers);
-        xwidgets_serialize(display(), state["display"], buffers);
-        xwidgets_serialize(flex(), state["flex"], buffers);
-        xwidgets_serialize(flex_flow(), state["flex_flow"], buffers);
-        xwidgets_serialize(height(), state["height"], buffers);
-        xwidgets_serialize(justify_content(), state["justify_content"], buffers);
-        xwidgets_serialize(left(), state["left"], buffers);
-        xwidgets_serialize(margin(), state["margin"], buffers);
-        xwidgets_serialize(max_height(), state["max_height"], buffers);
-        xwidgets_serialize(max_width(), state["max_width"], buffers);
-        xwidgets_serialize(min_height(), state["min_height"], buffers);
-        xwidgets_serialize(min_width(), state["min_width"], buffers);
-        xwidgets_serialize(overflow(), state["overflow"], buffers);
-        xwidgets_serialize(overflow_x(), state["overflow_x"], buffers);
-        xwidgets_serialize(overflow_y(), state["overflow_y"], buffers);
-        xwidgets_serialize(order(), state["order"], buffers);
-        xwidgets_serialize(padding(), state["padding"], buffers);
-        xwidgets_serialize(right(), state["right"], buffers);
-        xwidgets_serialize(top(), state["top"], buffers);
-        xwidgets_serialize(width(), state["width"], buffers);
-    }
-
     template <class D>
     inline void xlayout<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -125,6 +93,8 @@ namespace xw
         set_property_from_patch(margin, patch, buffers);
         set_property_from_patch(max_height, patch, buffers);
         set_property_from_patch(max_width, patch, buffers);
+        set_property_from_patch(min_height, patch, buffers);
+        set_property_from_patch(min_width, patch, buffers);
         set_property_from_patch(overflow, patch, buffers);
         set_property_from_patch(overflow_x, patch, buffers);
         set_property_from_patch(overflow_y, patch, buffers);
@@ -35,7 +35,6 @@ namespace xw
 
         using pair_type = xlink_pair_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(pair_type, derived_type, source);
@@ -71,7 +70,6 @@ namespace xw
 
         using pair_type = xdirectional_link_pair_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(pair_type, derived_type, source);
@@ -95,15 +93,6 @@ namespace xw
      * xlink implementation *
      ************************/
 
-    template <class D>
-    inline void xlink<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(source(), state["source"], buffers);
-        xwidgets_serialize(target(), state["target"], buffers);
-    }
-
     template <class D>
     inline void xlink<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -137,15 +126,6 @@ namespace xw
      * xdirectional_link implementation *
      ************************************/
 
-    template <class D>
-    inline void xdirectional_link<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(source(), state["source"], buffers);
-        xwidgets_serialize(target(), state["target"], buffers);
-    }
-
     template <class D>
     inline void xdirectional_link<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
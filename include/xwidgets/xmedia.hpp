@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 
+#include "xbuffer.hpp"
 #include "xmaterialize.hpp"
 #include "xwidget.hpp"
 
@@ -31,9 +32,8 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        using value_type = std::vector<char>;
+        using value_type = xbuffer;
 
-        void serialize_state(nl::json& state, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(value_type, derived_type, value);
@@ -54,20 +54,6 @@ namespace xw
      * xmedia implementation *
      *************************/
 
-    inline void xwidgets_serialize(const std::vector<char>& value, nl::json& j, xeus::buffer_sequence& buffers)
-    {
-        j = xbuffer_reference_prefix() + std::to_string(buffers.size());
-        buffers.emplace_back(value.data(), value.size());
-    }
-
-    template <class D>
-    inline void xmedia<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-    }
-
     template <class D>
     inline void xmedia<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
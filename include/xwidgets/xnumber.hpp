@@ -28,7 +28,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         using value_type = typename xnumber_traits<derived_type>::value_type;
@@ -53,17 +52,6 @@ namespace xw
      * xnumber implementation *
      **************************/
 
-    template <class D>
-    inline void xnumber<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-        xwidgets_serialize(min(), state["min"], buffers);
-        xwidgets_serialize(max(), state["max"], buffers);
-        xwidgets_serialize(description(), state["description"], buffers);
-    }
-
     template <class D>
     inline void xnumber<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -28,7 +28,6 @@ namespace xw
 
         using value_type = typename base_type::value_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(value_type, derived_type, step);
@@ -58,16 +57,6 @@ namespace xw
      * xnumeral implementation *
      ***************************/
 
-    template <class D>
-    inline void xnumeral<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(step(), state["step"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-        xwidgets_serialize(continuous_update(), state["continuous_update"], buffers);
-    }
-
     template <class D>
     inline void xnumeral<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -9,6 +9,7 @@
 #ifndef XOBJECT_HPP
 #define XOBJECT_HPP
 
+#include <memory>
 #include <string>
 
 #include "xtl/xoptional.hpp"
@@ -55,12 +56,13 @@ namespace xw
     template <class D>
     inline void xobject<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
     {
-        xwidgets_serialize(_model_module(), state["_model_module"], buffers);
-        xwidgets_serialize(_model_module_version(), state["_model_module_version"], buffers);
-        xwidgets_serialize(_model_name(), state["_model_name"], buffers);
-        xwidgets_serialize(_view_module(), state["_view_module"], buffers);
-        xwidgets_serialize(_view_module_version(), state["_view_module_version"], buffers);
-        xwidgets_serialize(_view_name(), state["_view_name"], buffers);
+        // The synchronized properties of the whole class hierarchy are the
+        // ones set by the apply_patch chain, which is recorded once per
+        // widget type into a property table. The serialized state is cached
+        // between calls, and only the properties changed since the previous
+        // call are serialized again.
+        const derived_type& widget = derived_cast();
+        this->serialize_cached_state(get_property_table(widget), std::addressof(widget), state, buffers);
     }
 
     template <class D>
@@ -0,0 +1,63 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_OPTION_INDEX_HPP
+#define XWIDGETS_OPTION_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "xwidgets_config.hpp"
+
+namespace xw
+{
+    /*****************************
+     * xoption_index declaration *
+     *****************************/
+
+    namespace detail
+    {
+        /**
+         * Hash index of the options of a selection widget, mapping an option
+         * to its first position.
+         *
+         * The index refers to the options it was built from without holding
+         * them, and is rebuilt when the options change. A lookup that does not
+         * agree with the options, which were modified in place, rebuilds it.
+         */
+        class XWIDGETS_API xoption_index
+        {
+        public:
+
+            using options_type = std::vector<std::string>;
+            using size_type = options_type::size_type;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+            xoption_index();
+
+            void rebuild(const options_type& options);
+
+            size_type find(const options_type& options, const std::string& value) const;
+            bool contains(const options_type& options, const std::string& value) const;
+
+        private:
+
+            size_type lookup(const options_type& options, const std::string& value) const;
+
+            // Positions plus one, 0 marking an empty slot
+            mutable std::vector<std::uint32_t> m_slots;
+            mutable const std::string* p_data;
+            mutable size_type m_size;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,91 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_OPTION_STORE_HPP
+#define XWIDGETS_OPTION_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xoption_index.hpp"
+#include "xwidgets_config.hpp"
+
+namespace nl = nlohmann;
+
+namespace xw
+{
+    /*****************************
+     * xoption_store declaration *
+     *****************************/
+
+    /**
+     * Window of the options of a store: the positions of the options from
+     * offset, among the total number of options matching the request.
+     */
+    struct xoption_page
+    {
+        using size_type = std::vector<std::string>::size_type;
+
+        size_type offset = 0;
+        size_type total = 0;
+        std::vector<size_type> indices;
+    };
+
+    /**
+     * Options of a paged selection widget, held in the kernel and served to
+     * the front-end by pages.
+     *
+     * Options are looked up by value with a hash index. Pages are taken in
+     * the order of the options, or, when filtered by a prefix, in the order
+     * of the labels, with a sorted index built on the first filtered
+     * request.
+     */
+    class XWIDGETS_API xoption_store
+    {
+    public:
+
+        using options_type = std::vector<std::string>;
+        using size_type = options_type::size_type;
+
+        static constexpr size_type npos = detail::xoption_index::npos;
+        // Largest page sent in reply to a request
+        static constexpr size_type max_page_size = 1000;
+
+        xoption_store();
+        explicit xoption_store(options_type options);
+
+        void assign(options_type options);
+
+        const options_type& options() const noexcept;
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+        const std::string& operator[](size_type i) const;
+
+        size_type find(const std::string& value) const;
+
+        xoption_page page(size_type offset, size_type count) const;
+        xoption_page page(const std::string& prefix, size_type offset, size_type count) const;
+
+        nl::json reply(const nl::json& request) const;
+
+    private:
+
+        const std::vector<std::uint32_t>& sorted() const;
+
+        options_type m_options;
+        detail::xoption_index m_index;
+        // Positions of the options in the order of their labels
+        mutable std::vector<std::uint32_t> m_sorted;
+    };
+}
+
+#endif
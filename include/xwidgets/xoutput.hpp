@@ -32,7 +32,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, msg_id);
@@ -71,15 +70,6 @@ namespace xw
      * xoutput implementation *
      **************************/
 
-    template <class D>
-    inline void xoutput<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(msg_id(), state["msg_id"], buffers);
-        xwidgets_serialize(outputs(), state["outputs"], buffers);
-    }
-
     template <class D>
     inline void xoutput<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -0,0 +1,462 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_PAGED_SELECTION_HPP
+#define XWIDGETS_PAGED_SELECTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xmaterialize.hpp"
+#include "xoption_store.hpp"
+#include "xwidget.hpp"
+
+namespace xw
+{
+    /********************************
+     * xpaged_selection declaration *
+     ********************************/
+
+    /**
+     * Selection widget whose options are held in the kernel and sent to the
+     * front-end by pages.
+     *
+     * The state holds the number of options and a window of options, the
+     * page of first_page_size options holding the selected one, starting at
+     * _options_offset. The index of the state refers to the window, so that
+     * the selection models of the front-end, which do not page, show the
+     * options of the window. The window moves when an option outside of it
+     * is selected in the kernel.
+     *
+     * Front-ends that page request the other pages with custom messages:
+     *
+     * - request: ``{"event": "page", "offset": o, "count": c, "prefix": p,
+     *   "request": r}``, prefix and request being optional.
+     * - reply: ``{"event": "page", "request": r, "version": v, "prefix": p,
+     *   "offset": o, "total": t, "indices": [...], "labels": [...]}``.
+     * - selection: ``{"event": "select", "position": i}``.
+     *
+     * Without prefix, pages are taken in the order of the options. With a
+     * prefix, they are taken among the options starting with it, in the
+     * order of the labels. The indices are the positions of the options,
+     * which are selected with the select event. The version is incremented
+     * when the options are replaced, so that front-ends can drop the replies
+     * to former options.
+     */
+    template <class D>
+    class xpaged_selection : public xwidget<D>
+    {
+    public:
+
+        using base_type = xwidget<D>;
+        using derived_type = D;
+
+        using options_type = xoption_store::options_type;
+        using value_type = options_type::value_type;
+        using index_type = options_type::size_type;
+
+        // Number of options sent in the state
+        static constexpr index_type first_page_size = 100;
+
+        void apply_patch(const nl::json&, const xeus::buffer_sequence&);
+
+        void handle_custom_message(const nl::json&);
+
+        const xoption_store& options() const noexcept;
+        void set_options(options_type options);
+
+        index_type position() const;
+        void select(index_type position);
+
+        // index in _options_labels
+        XPROPERTY(index_type, derived_type, index);
+        XPROPERTY(options_type, derived_type, _options_labels);
+        XPROPERTY(index_type, derived_type, _options_offset);
+        XPROPERTY(index_type, derived_type, _options_count);
+        XPROPERTY(std::size_t, derived_type, _options_version);
+
+        XPROPERTY(std::string, derived_type, description);
+        XPROPERTY(bool, derived_type, disabled, false);
+
+        // non-synchronized properties
+        XPROPERTY(value_type, derived_type, value);
+
+    protected:
+
+        xpaged_selection();
+
+        template <class O, class T>
+        xpaged_selection(O&& options, T&& value);
+
+        using base_type::base_type;
+
+    private:
+
+        void set_defaults();
+
+        void setup_properties();
+
+        void show_window(index_type position, bool reload);
+        options_type window(index_type offset) const;
+
+        xoption_store m_options;
+    };
+
+    /****************************
+     * paged_select declaration *
+     ****************************/
+
+    template <class D>
+    class xpaged_select : public xpaged_selection<D>
+    {
+    public:
+
+        using base_type = xpaged_selection<D>;
+        using derived_type = D;
+
+        void apply_patch(const nl::json&, const xeus::buffer_sequence&);
+
+        XPROPERTY(int, derived_type, rows, 5);
+
+    protected:
+
+        xpaged_select();
+
+        template <class O, class T>
+        xpaged_select(O&& options, T&& value);
+
+        using base_type::base_type;
+
+    private:
+
+        void set_defaults();
+    };
+
+    using paged_select = xmaterialize<xpaged_select>;
+
+    /******************************
+     * paged_dropdown declaration *
+     ******************************/
+
+    template <class D>
+    class xpaged_dropdown : public xpaged_selection<D>
+    {
+    public:
+
+        using base_type = xpaged_selection<D>;
+        using derived_type = D;
+
+        void apply_patch(const nl::json&, const xeus::buffer_sequence&);
+
+    protected:
+
+        xpaged_dropdown();
+
+        template <class O, class T>
+        xpaged_dropdown(O&& options, T&& value);
+
+        using base_type::base_type;
+
+    private:
+
+        void set_defaults();
+    };
+
+    using paged_dropdown = xmaterialize<xpaged_dropdown>;
+
+    /***********************************
+     * xpaged_selection implementation *
+     ***********************************/
+
+    template <class D>
+    constexpr typename xpaged_selection<D>::index_type xpaged_selection<D>::first_page_size;
+
+    template <class D>
+    inline void xpaged_selection<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
+    {
+        base_type::apply_patch(patch, buffers);
+
+        set_property_from_patch(index, patch, buffers);
+        set_readonly_property_from_patch(_options_labels, patch, buffers);
+        set_readonly_property_from_patch(_options_offset, patch, buffers);
+        set_readonly_property_from_patch(_options_count, patch, buffers);
+        set_readonly_property_from_patch(_options_version, patch, buffers);
+        set_property_from_patch(description, patch, buffers);
+        set_property_from_patch(disabled, patch, buffers);
+    }
+
+    template <class D>
+    inline void xpaged_selection<D>::handle_custom_message(const nl::json& content)
+    {
+        auto it = content.find("event");
+        if (it == content.end())
+        {
+            return;
+        }
+        if (it.value() == "page")
+        {
+            nl::json reply = m_options.reply(content);
+            reply["version"] = this->_options_version();
+            this->send(std::move(reply), xeus::buffer_sequence());
+        }
+        else if (it.value() == "select")
+        {
+            auto position = content.find("position");
+            if (position != content.end() && position->is_number_integer() && *position >= 0)
+            {
+                select(position->template get<index_type>());
+            }
+        }
+    }
+
+    template <class D>
+    inline const xoption_store& xpaged_selection<D>::options() const noexcept
+    {
+        return m_options;
+    }
+
+    /**
+     * Replaces the options. The value is kept when it is one of the new
+     * options, else the first option is selected. Without options, the
+     * value is empty.
+     */
+    template <class D>
+    inline void xpaged_selection<D>::set_options(options_type options)
+    {
+        m_options.assign(std::move(options));
+
+        auto guard = this->hold_sync();
+        this->_options_version = this->_options_version() + 1;
+        this->_options_count = m_options.size();
+
+        index_type position = m_options.find(this->value());
+        if (position == xoption_store::npos)
+        {
+            position = 0;
+            if (m_options.empty())
+            {
+                // The empty value is not an option: it is not validated
+                this->value() = value_type();
+                this->notify("value", this->value());
+                this->invoke_observers("value");
+            }
+            else
+            {
+                this->value = m_options[0];
+            }
+        }
+        show_window(position, true);
+    }
+
+    /**
+     * Position of the selected option among all the options, npos when there
+     * are no options.
+     */
+    template <class D>
+    inline auto xpaged_selection<D>::position() const -> index_type
+    {
+        return m_options.empty() ? xoption_store::npos : this->_options_offset() + this->index();
+    }
+
+    /**
+     * Selects the option at position among all the options, moving the
+     * window of options sent to the front-end if needed.
+     */
+    template <class D>
+    inline void xpaged_selection<D>::select(index_type position)
+    {
+        if (position >= m_options.size())
+        {
+            throw std::out_of_range("Invalid option position");
+        }
+        this->value = m_options[position];
+    }
+
+    template <class D>
+    inline xpaged_selection<D>::xpaged_selection()
+        : base_type()
+    {
+        set_defaults();
+
+        this->setup_properties();
+    }
+
+    template <class D>
+    template <class O, class T>
+    inline xpaged_selection<D>::xpaged_selection(O&& options, T&& v)
+        : base_type()
+    {
+        set_defaults();
+
+        m_options.assign(options_type(std::forward<O>(options)));
+        this->value() = std::forward<T>(v);
+        this->_options_count() = m_options.size();
+        index_type position = m_options.find(this->value());
+        if (position == xoption_store::npos)
+        {
+            position = 0;
+        }
+        this->_options_offset() = position - position % first_page_size;
+        this->_options_labels() = window(this->_options_offset());
+        this->index() = position - this->_options_offset();
+
+        this->setup_properties();
+    }
+
+    template <class D>
+    inline void xpaged_selection<D>::setup_properties()
+    {
+        this->observe("value", [](auto& owner) {
+            owner.show_window(owner.m_options.find(owner.value()), false);
+        });
+
+        // The index is relative to the window
+        this->observe("index", [](auto& owner) {
+            index_type position = owner._options_offset() + owner.index();
+            if (owner.index() < owner._options_labels().size() && position < owner.m_options.size())
+            {
+                const value_type& new_value = owner.m_options[position];
+                if (new_value != owner.value())
+                {
+                    owner.value = new_value;
+                }
+            }
+        });
+
+        this->template validate<value_type>("value", [](auto& owner, auto& proposal) {
+            if (owner.m_options.find(proposal) == xoption_store::npos)
+            {
+                throw std::runtime_error("Invalid value");
+            }
+        });
+    }
+
+    // Sends the window holding position, and the index of position in it.
+    // The window is sent again when reload is true.
+    template <class D>
+    inline void xpaged_selection<D>::show_window(index_type position, bool reload)
+    {
+        if (position == xoption_store::npos)
+        {
+            position = 0;
+        }
+        auto guard = this->hold_sync();
+        index_type offset = position - position % first_page_size;
+        if (reload || offset != this->_options_offset())
+        {
+            this->_options_offset = offset;
+            this->_options_labels = window(offset);
+        }
+        if (position - offset != this->index())
+        {
+            this->index = position - offset;
+        }
+    }
+
+    template <class D>
+    inline auto xpaged_selection<D>::window(index_type offset) const -> options_type
+    {
+        const options_type& opt = m_options.options();
+        offset = std::min(offset, opt.size());
+        return options_type(opt.cbegin() + offset, opt.cbegin() + std::min(opt.size(), offset + first_page_size));
+    }
+
+    template <class D>
+    inline void xpaged_selection<D>::set_defaults()
+    {
+    }
+
+    /********************************
+     * xpaged_select implementation *
+     ********************************/
+
+    template <class D>
+    inline void xpaged_select<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
+    {
+        base_type::apply_patch(patch, buffers);
+
+        set_property_from_patch(rows, patch, buffers);
+    }
+
+    template <class D>
+    inline xpaged_select<D>::xpaged_select()
+        : base_type()
+    {
+        set_defaults();
+    }
+
+    template <class D>
+    template <class O, class T>
+    inline xpaged_select<D>::xpaged_select(O&& options, T&& value)
+        : base_type(std::forward<O>(options), std::forward<T>(value))
+    {
+        set_defaults();
+    }
+
+    template <class D>
+    inline void xpaged_select<D>::set_defaults()
+    {
+        this->_model_name() = "SelectModel";
+        this->_view_name() = "SelectView";
+        this->_model_module() = "@jupyter-widgets/controls";
+        this->_view_module() = "@jupyter-widgets/controls";
+        this->_model_module_version() = XWIDGETS_CONTROLS_VERSION;
+        this->_view_module_version() = XWIDGETS_CONTROLS_VERSION;
+    }
+
+    /**********************************
+     * xpaged_dropdown implementation *
+     **********************************/
+
+    template <class D>
+    inline void xpaged_dropdown<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
+    {
+        base_type::apply_patch(patch, buffers);
+    }
+
+    template <class D>
+    inline xpaged_dropdown<D>::xpaged_dropdown()
+        : base_type()
+    {
+        set_defaults();
+    }
+
+    template <class D>
+    template <class O, class T>
+    inline xpaged_dropdown<D>::xpaged_dropdown(O&& options, T&& value)
+        : base_type(std::forward<O>(options), std::forward<T>(value))
+    {
+        set_defaults();
+    }
+
+    template <class D>
+    inline void xpaged_dropdown<D>::set_defaults()
+    {
+        this->_model_name() = "DropdownModel";
+        this->_view_name() = "DropdownView";
+        this->_model_module() = "@jupyter-widgets/controls";
+        this->_view_module() = "@jupyter-widgets/controls";
+        this->_model_module_version() = XWIDGETS_CONTROLS_VERSION;
+        this->_view_module_version() = XWIDGETS_CONTROLS_VERSION;
+    }
+
+    /*********************
+     * precompiled types *
+     *********************/
+
+    extern template class xmaterialize<xpaged_select>;
+    extern template class xtransport<xmaterialize<xpaged_select>>;
+
+    extern template class xmaterialize<xpaged_dropdown>;
+    extern template class xtransport<xmaterialize<xpaged_dropdown>>;
+}
+#endif
@@ -26,7 +26,6 @@ namespace xw
         using base_type = xstring<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(bool, derived_type, disabled);
@@ -47,14 +46,6 @@ namespace xw
      * xpassword implementation *
      ****************************/
 
-    template <class D>
-    inline void xpassword<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-    }
-
     template <class D>
     inline void xpassword<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
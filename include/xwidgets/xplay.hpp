@@ -28,9 +28,12 @@ namespace xw
 
         using value_type = typename base_type::value_type;
 
-        void serialize_state(nl::json& state, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
+        // Steps the value as the front-end does when playing, for the
+        // kernel to drive the widget. Returns false at max without _repeat.
+        bool advance();
+
         XPROPERTY(value_type, derived_type, interval, value_type(100));
         XPROPERTY(value_type, derived_type, step, value_type(1));
         XPROPERTY(bool, derived_type, disabled);
@@ -60,19 +63,6 @@ namespace xw
      * xplay implementation *
      ************************/
 
-    template <class D>
-    inline void xplay<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(interval(), state["interval"], buffers);
-        xwidgets_serialize(step(), state["step"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-        xwidgets_serialize(_playing(), state["_playing"], buffers);
-        xwidgets_serialize(_repeat(), state["_repeat"], buffers);
-        xwidgets_serialize(show_repeat(), state["show_repeat"], buffers);
-    }
-
     template <class D>
     inline void xplay<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -86,6 +76,24 @@ namespace xw
         set_property_from_patch(show_repeat, patch, buffers);
     }
 
+    template <class D>
+    inline bool xplay<D>::advance()
+    {
+        value_type next = this->value() + step();
+        if (next <= this->max())
+        {
+            this->value = next;
+            return true;
+        }
+        if (_repeat())
+        {
+            this->value = this->min();
+            return true;
+        }
+        this->value = this->max();
+        return false;
+    }
+
     template <class D>
     inline xplay<D>::xplay()
         : base_type()
@@ -0,0 +1,188 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_POST_HPP
+#define XWIDGETS_POST_HPP
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "xeus/xguid.hpp"
+
+#include "xcancellation.hpp"
+#include "xholder.hpp"
+#include "xwidgets_config.hpp"
+
+namespace xw
+{
+    template <class D>
+    class xtransport;
+
+    /********************
+     * post declaration *
+     ********************/
+
+    /**
+     * Whether the calling thread is the kernel thread, the one handling
+     * the messages of the front-end.
+     */
+    XWIDGETS_API bool is_kernel_thread();
+
+    /**
+     * Makes the calling thread the kernel thread. The thread loading the
+     * library, which is the thread of the interpreter, is the kernel thread.
+     * A kernel handling the messages of the front-end on another thread
+     * calls this from that thread when it starts.
+     */
+    XWIDGETS_API void set_kernel_thread();
+
+    /**
+     * Runs f with the widget on the kernel thread.
+     *
+     * When called from another thread, f is queued and run by the next
+     * call to process_posted_tasks on the kernel thread, provided that the
+     * widget still exists. Called from the kernel thread, f is run at once.
+     */
+    template <class D, class F>
+    void post(xtransport<D>& widget, F&& f);
+
+    /**
+     * Runs f with the widget on the kernel thread, as post does. When
+     * called from another thread, f replaces the function posted with the
+     * same key for the widget that has not run yet, so that only the last
+     * of a series of updates is applied.
+     */
+    template <class D, class F>
+    void post(xtransport<D>& widget, const std::string& key, F&& f);
+
+    /**
+     * Runs f with the widget on the kernel thread, unless token has been
+     * cancelled by then. This applies the result of some work only if it
+     * has not been superseded in the meantime. Like other posted tasks, the
+     * result is only applied when the kernel thread processes the posted
+     * tasks, and waits on an idle kernel without a kernel wakeup.
+     */
+    template <class D, class F>
+    void post(xtransport<D>& widget, const xcancellation_token& token, F&& f);
+
+    /**
+     * Runs the tasks posted from other threads, in the order they were
+     * posted.
+     *
+     * This is called on the kernel thread at the end of each message
+     * received from the front-end, and by the kernel wakeup if one is set
+     * (see set_kernel_wakeup). Otherwise, posted tasks wait for the next
+     * message on an idle kernel. Code running a loop on the kernel thread,
+     * such as a cell waiting for worker threads, may call it to deliver the
+     * updates of the workers.
+     */
+    XWIDGETS_API void process_posted_tasks();
+
+    /**
+     * Runs the posted tasks as they arrive until deadline, and flushes the
+     * updates they make, blocking the kernel thread in between.
+     *
+     * This lets a cell drive live updates from worker threads or tickers
+     * without a busy-wait loop. It returns at once when called from another
+     * thread.
+     */
+    XWIDGETS_API void process_posted_tasks_until(std::chrono::steady_clock::time_point deadline);
+
+    template <class R, class P>
+    void process_posted_tasks_for(const std::chrono::duration<R, P>& duration);
+
+    /**
+     * Sets the function called when a task is posted while none is pending,
+     * from another thread or by a timer of the library.
+     *
+     * Kernels whose event loop can run a callback on the kernel thread set
+     * it to a function scheduling process_posted_tasks there, so that the
+     * updates of worker threads and the delayed patches are sent while no
+     * cell runs. Without it, posted tasks wait for the next message from
+     * the front-end or for a call to process_posted_tasks. The function is
+     * called on the posting thread.
+     */
+    XWIDGETS_API void set_kernel_wakeup(std::function<void()> wakeup);
+
+    namespace detail
+    {
+        using posted_task = std::function<void(xholder&)>;
+
+        // Queues task, to be run with the holder of the widget id. When key
+        // is not empty, a task replaces the pending task of the same widget
+        // and key. Tasks posted with an empty id are not bound to a widget
+        // and are run with an empty holder.
+        XWIDGETS_API void post_task(const xeus::xguid& id, const std::string& key, posted_task&& task);
+
+        // Posts task as post_task does once deadline is reached, from a
+        // timer thread. A task replaces the scheduled task of the same
+        // widget and key.
+        XWIDGETS_API void post_task_at(std::chrono::steady_clock::time_point deadline,
+                                       const xeus::xguid& id,
+                                       const std::string& key,
+                                       posted_task&& task);
+    }
+
+    /***********************
+     * post implementation *
+     ***********************/
+
+    template <class R, class P>
+    inline void process_posted_tasks_for(const std::chrono::duration<R, P>& duration)
+    {
+        process_posted_tasks_until(std::chrono::steady_clock::now() + duration);
+    }
+
+    template <class D, class F>
+    inline void post(xtransport<D>& widget, F&& f)
+    {
+        if (is_kernel_thread())
+        {
+            f(widget.derived_cast());
+            return;
+        }
+        // Shared so that move-only functions can be held in std::function
+        auto shared_f = std::make_shared<std::decay_t<F>>(std::forward<F>(f));
+        detail::post_task(widget.id(), std::string(), [shared_f](xholder& holder) {
+            (*shared_f)(holder.template get<D>());
+        });
+    }
+
+    template <class D, class F>
+    inline void post(xtransport<D>& widget, const std::string& key, F&& f)
+    {
+        if (is_kernel_thread())
+        {
+            f(widget.derived_cast());
+            return;
+        }
+        auto shared_f = std::make_shared<std::decay_t<F>>(std::forward<F>(f));
+        // Prefixed so as not to replace the tasks posted by the library
+        detail::post_task(widget.id(), "post/" + key, [shared_f](xholder& holder) {
+            (*shared_f)(holder.template get<D>());
+        });
+    }
+
+    template <class D, class F>
+    inline void post(xtransport<D>& widget, const xcancellation_token& token, F&& f)
+    {
+        auto shared_f = std::make_shared<std::decay_t<F>>(std::forward<F>(f));
+        post(widget, [token, shared_f](D& w) {
+            if (!token.cancelled())
+            {
+                (*shared_f)(w);
+            }
+        });
+    }
+}
+
+#endif
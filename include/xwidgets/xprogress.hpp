@@ -33,7 +33,6 @@ namespace xw
         using base_type = xstyle<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, description_width);
@@ -65,7 +64,6 @@ namespace xw
 
         using value_type = typename base_type::value_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, orientation, "horizontal", XEITHER("horizontal", "vertical"));
@@ -95,15 +93,6 @@ namespace xw
      * xprogress_style implementation *
      **********************************/
 
-    template <class D>
-    inline void xprogress_style<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(description_width(), state["description_width"], buffers);
-        xwidgets_serialize(bar_color(), state["bar_color"], buffers);
-    }
-
     template <class D>
     inline void xprogress_style<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -132,16 +121,6 @@ namespace xw
      * xprogress implementation *
      ****************************/
 
-    template <class D>
-    inline void xprogress<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(orientation(), state["orientation"], buffers);
-        xwidgets_serialize(bar_style(), state["bar_style"], buffers);
-        xwidgets_serialize(style(), state["style"], buffers);
-    }
-
     template <class D>
     inline void xprogress<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
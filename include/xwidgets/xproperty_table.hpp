@@ -0,0 +1,153 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_PROPERTY_TABLE_HPP
+#define XWIDGETS_PROPERTY_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xmessage.hpp"
+
+#include "xwidgets_config.hpp"
+
+namespace nl = nlohmann;
+
+namespace xw
+{
+    /*******************************
+     * xproperty_table declaration *
+     *******************************/
+
+    /**
+     * Table of the synchronized properties of a widget type. Each descriptor
+     * holds the name of a property, its offset in the widget, the functions
+     * serializing and deserializing its value, and the functions reading and
+     * assigning its value, which is used to assign the property on the
+     * kernel thread on behalf of another thread.
+     *
+     * The names are looked up with a perfect hash built once per widget type,
+     * so that applying an inbound patch only visits the keys present in the
+     * patch instead of searching the patch for every declared property.
+     */
+    class XWIDGETS_API xproperty_table
+    {
+    public:
+
+        using setter_type = void (*)(void*, const nl::json&, const xeus::buffer_sequence&);
+        using serializer_type = void (*)(const void*, nl::json&, xeus::buffer_sequence&);
+        using getter_type = const void* (*)(const void*);
+        using assigner_type = void (*)(void*, const void*);
+
+        struct descriptor
+        {
+            std::string name;
+            std::ptrdiff_t offset;
+            setter_type setter;
+            serializer_type serializer;
+            getter_type getter;
+            assigner_type assigner;
+        };
+
+        void add(const std::string& name,
+                 std::ptrdiff_t offset,
+                 setter_type setter,
+                 serializer_type serializer,
+                 getter_type getter,
+                 assigner_type assigner);
+        void build();
+
+        std::size_t size() const noexcept;
+        const descriptor* find(const std::string& name) const noexcept;
+
+        bool apply(void* widget, const nl::json& patch, const xeus::buffer_sequence& buffers) const;
+
+        void serialize(const void* widget, nl::json& state, xeus::buffer_sequence& buffers) const;
+        void serialize(const void* widget,
+                       const std::vector<std::string>& names,
+                       nl::json& state,
+                       xeus::buffer_sequence& buffers) const;
+
+    private:
+
+        std::size_t slot(const std::string& name, std::uint64_t seed) const noexcept;
+
+        // Descriptors are kept in the order of the apply_patch chain
+        std::vector<descriptor> m_descriptors;
+        std::vector<std::size_t> m_slots;
+        std::uint64_t m_seed = 0;
+    };
+
+    /**********************************
+     * xproperty_recorder declaration *
+     **********************************/
+
+    /**
+     * While an xproperty_recorder is alive, set_property_from_patch records
+     * the properties it is called for into the table of the recorder instead
+     * of reading the patch.
+     */
+    class XWIDGETS_API xproperty_recorder
+    {
+    public:
+
+        xproperty_recorder(xproperty_table& table, const void* widget);
+        ~xproperty_recorder();
+
+        xproperty_recorder(const xproperty_recorder&) = delete;
+        xproperty_recorder& operator=(const xproperty_recorder&) = delete;
+
+        static xproperty_recorder* current() noexcept;
+
+        void record(const std::string& name,
+                    const void* property,
+                    xproperty_table::setter_type setter,
+                    xproperty_table::serializer_type serializer,
+                    xproperty_table::getter_type getter,
+                    xproperty_table::assigner_type assigner);
+
+    private:
+
+        xproperty_table& m_table;
+        const char* p_widget;
+        xproperty_recorder* p_previous;
+    };
+
+    template <class D>
+    const xproperty_table& get_property_table(const D& widget);
+
+    /*************************************
+     * get_property_table implementation *
+     *************************************/
+
+    template <class D>
+    inline const xproperty_table& get_property_table(const D& widget)
+    {
+        // The layout of D being the same for all its instances, the table
+        // recorded on the first widget applies to all of them. Recording
+        // applies an empty patch, which leaves the widget unchanged.
+        static const xproperty_table table = [&widget]() {
+            xproperty_table res;
+            {
+                xproperty_recorder recorder(res, std::addressof(widget));
+                const_cast<D&>(widget).apply_patch(nl::json::object(), xeus::buffer_sequence());
+            }
+            res.build();
+            return res;
+        }();
+        return table;
+    }
+}
+
+#endif
@@ -29,7 +29,6 @@ namespace xw
         using derived_type = D;
         using options_type = typename base_type::options_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
     protected:
@@ -52,12 +51,6 @@ namespace xw
      * xradiobuttons implementation *
      ********************************/
 
-    template <class D>
-    inline void xradiobuttons<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-    }
-
     template <class D>
     inline void xradiobuttons<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
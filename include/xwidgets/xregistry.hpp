@@ -9,7 +9,11 @@
 #ifndef XWIDGETS_REGISTRY_HPP
 #define XWIDGETS_REGISTRY_HPP
 
-#include <unordered_map>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "xeus/xguid.hpp"
 
@@ -18,6 +22,25 @@
 
 namespace xw
 {
+    /**************************
+     * xwidget_id declaration *
+     **************************/
+
+    /**
+     * Binary form of the id of a widget. The 32 hexadecimal digits of a
+     * GUID are parsed into 128 bits, other ids are hashed.
+     */
+    struct xwidget_id
+    {
+        std::uint64_t high = 0;
+        std::uint64_t low = 0;
+    };
+
+    XWIDGETS_API xwidget_id make_widget_id(const xeus::xguid& guid);
+
+    XWIDGETS_API bool operator==(const xwidget_id& lhs, const xwidget_id& rhs) noexcept;
+    XWIDGETS_API bool operator!=(const xwidget_id& lhs, const xwidget_id& rhs) noexcept;
+
     /*************************
      * xregistry declaration *
      *************************/
@@ -25,12 +48,46 @@ namespace xw
     template <class D>
     class xtransport;
 
+    /**
+     * Registry of the live widgets, indexed by id.
+     *
+     * Widgets may be created, moved and destroyed from several threads. The
+     * registry is split into shards selected by the id, each of them indexing
+     * its holders with an open-addressing table of binary ids, where erasing
+     * shifts the following slots back instead of leaving tombstones.
+     *
+     * Registering and unregistering are serialized by a mutex per shard.
+     * Lookups do not lock: they read the table between two reads of the
+     * sequence number of the shard, which is odd while it is changed, and
+     * retry when it differs.
+     *
+     * The holders are stored in chunks that are never reallocated, so that
+     * a handle (the shard and index of a holder) remains valid until the
+     * widget is unregistered. The generation of a handle changes whenever
+     * the widget is registered, moved or unregistered.
+     *
+     * Registering, unregistering, and looking up handles and generations
+     * may be done from any thread. The holder returned by find and get is
+     * not guarded once returned: it is replaced when the widget is moved and
+     * destroyed when it is unregistered, so that it may only be used on the
+     * thread moving and destroying the widget, which is the kernel thread
+     * for widgets displayed in a notebook.
+     */
     class xregistry
     {
     public:
 
         using holder_type = xholder;
-        using storage_type = std::unordered_map<xeus::xguid, holder_type>;
+        using handle_type = std::uint32_t;
+        using generation_type = std::uint32_t;
+
+        static constexpr handle_type npos = static_cast<handle_type>(-1);
+
+        XWIDGETS_API xregistry();
+        XWIDGETS_API ~xregistry();
+
+        xregistry(const xregistry&) = delete;
+        xregistry& operator=(const xregistry&) = delete;
 
         template <class D>
         void register_weak(xtransport<D>* ptr);
@@ -38,13 +95,31 @@ namespace xw
         template <class D>
         void register_owning(xtransport<D>&& model);
 
+        XWIDGETS_API void insert(xeus::xguid id, holder_type&& holder);
+
         XWIDGETS_API void unregister(xeus::xguid id);
 
-        XWIDGETS_API typename storage_type::mapped_type& find(xeus::xguid id);
+        XWIDGETS_API holder_type& find(xeus::xguid id);
+        XWIDGETS_API holder_type& find(const xwidget_id& id);
+
+        XWIDGETS_API handle_type handle(const xwidget_id& id) const;
+        XWIDGETS_API holder_type& get(handle_type handle);
+        XWIDGETS_API generation_type generation(handle_type handle) const noexcept;
+
+        XWIDGETS_API std::size_t size() const noexcept;
+
+        template <class F>
+        void for_each(F&& f) const;
 
     private:
 
-        storage_type m_storage;
+        struct shard;
+
+        shard& get_shard(const xwidget_id& id) const noexcept;
+        std::vector<const holder_type*> holders() const;
+
+        std::unique_ptr<shard[]> p_shards;
+        std::atomic<std::size_t> m_size;
     };
 
     XWIDGETS_API xregistry& get_transport_registry();
@@ -56,15 +131,26 @@ namespace xw
     template <class D>
     void xregistry::register_weak(xtransport<D>* ptr)
     {
-        m_storage[ptr->id()] = make_weak_holder(ptr);
+        insert(ptr->id(), make_weak_holder(ptr));
     }
 
     template <class D>
     void xregistry::register_owning(xtransport<D>&& model)
     {
-        m_storage[model.id()] = make_owning_holder(std::move(model));
+        xeus::xguid id = model.id();
+        insert(id, make_owning_holder(std::move(model)));
+    }
+
+    template <class F>
+    void xregistry::for_each(F&& f) const
+    {
+        // f is called without holding the locks, so that it may register
+        // or unregister widgets.
+        for (const holder_type* holder : holders())
+        {
+            f(*holder);
+        }
     }
 }
 
 #endif
-
@@ -27,7 +27,6 @@ namespace xw
         using derived_type = D;
         using options_type = typename base_type::options_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(int, derived_type, rows, 5);
@@ -61,7 +60,6 @@ namespace xw
         using derived_type = D;
         using options_type = typename base_type::options_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(int, derived_type, rows, 5);
@@ -85,14 +83,6 @@ namespace xw
      * xselect implementation *
      **************************/
 
-    template <class D>
-    inline void xselect<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(rows(), state["rows"], buffers);
-    }
-
     template <class D>
     inline void xselect<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -131,14 +121,6 @@ namespace xw
      * xselect_multiple implementation *
      ***********************************/
 
-    template <class D>
-    inline void xselect_multiple<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(rows(), state["rows"], buffers);
-    }
-
     template <class D>
     inline void xselect_multiple<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
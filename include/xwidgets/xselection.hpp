@@ -9,12 +9,12 @@
 #ifndef XWIDGETS_SELECTION_HPP
 #define XWIDGETS_SELECTION_HPP
 
-#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "xoption_index.hpp"
 #include "xwidget.hpp"
 
 namespace xw
@@ -31,7 +31,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         using options_type = std::vector<std::string>;
@@ -61,6 +60,8 @@ namespace xw
         void set_defaults();
 
         void setup_properties();
+
+        detail::xoption_index m_option_index;
     };
 
     /***********************************
@@ -75,7 +76,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         using options_type = std::vector<std::string>;
@@ -104,23 +104,14 @@ namespace xw
         void set_defaults();
 
         void setup_properties();
+
+        detail::xoption_index m_option_index;
     };
 
     /*****************************
      * xselection implementation *
      *****************************/
 
-    template <class D>
-    inline void xselection<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(index(), state["index"], buffers);
-        xwidgets_serialize(_options_labels(), state["_options_labels"], buffers);
-        xwidgets_serialize(description(), state["description"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-    }
-
     template <class D>
     inline void xselection<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -158,8 +149,7 @@ namespace xw
     inline void xselection<D>::setup_properties()
     {
         this->observe("value", [](auto& owner) {
-            const options_type& opt = owner._options_labels();
-            auto new_index = index_type(std::find(opt.cbegin(), opt.cend(), owner.value()) - opt.cbegin());
+            auto new_index = index_type(owner.m_option_index.find(owner._options_labels(), owner.value()));
             if (new_index != owner.index())
             {
                 owner.index = new_index;
@@ -176,17 +166,13 @@ namespace xw
 
         this->observe("_options_labels", [](auto& owner) {
             const options_type& opt = owner._options_labels();
-            auto position = std::find(opt.cbegin(), opt.cend(), owner.value());
-            if (position == opt.cend())
-            {
-                position = opt.cbegin();
-            }
-            owner.index = position - opt.cbegin();
+            owner.m_option_index.rebuild(opt);
+            auto position = owner.m_option_index.find(opt, owner.value());
+            owner.index = position != detail::xoption_index::npos ? position : 0;
         });
 
         this->template validate<value_type>("value", [](auto& owner, auto& proposal) {
-            const options_type& opt = owner._options_labels();
-            if (std::find(opt.cbegin(), opt.cend(), proposal) == opt.cend())
+            if (!owner.m_option_index.contains(owner._options_labels(), proposal))
             {
                 throw std::runtime_error("Invalid value");
             }
@@ -202,17 +188,6 @@ namespace xw
      * xmultiple_selection implementation *
      **************************************/
 
-    template <class D>
-    inline void xmultiple_selection<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(index(), state["index"], buffers);
-        xwidgets_serialize(_options_labels(), state["_options_labels"], buffers);
-        xwidgets_serialize(description(), state["description"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-    }
-
     template <class D>
     inline void xmultiple_selection<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -257,9 +232,10 @@ namespace xw
         this->observe("value", [](auto& owner) {
             const options_type& opt = owner._options_labels();
             index_type new_index;
+            new_index.reserve(owner.value().size());
             for (const auto& val : owner.value())
             {
-                new_index.push_back(std::find(opt.cbegin(), opt.cend(), val) - opt.cbegin());
+                new_index.push_back(owner.m_option_index.find(opt, val));
             }
             if (new_index != owner.index())
             {
@@ -280,6 +256,7 @@ namespace xw
         });
 
         this->observe("_options_labels", [](auto& owner) {
+            owner.m_option_index.rebuild(owner._options_labels());
             owner.index = index_type();
         });
 
@@ -287,7 +264,7 @@ namespace xw
             const options_type& opt = owner._options_labels();
             for (const auto& val : proposal)
             {
-                if (std::find(opt.cbegin(), opt.cend(), val) == opt.cend())
+                if (!owner.m_option_index.contains(opt, val))
                 {
                     throw std::runtime_error("Invalid value");
                 }
@@ -33,7 +33,6 @@ namespace xw
 
         using titles_type = std::vector<std::string>;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(titles_type, derived_type, _titles);
@@ -55,15 +54,6 @@ namespace xw
      * xselection_container implementation *
      ***************************************/
 
-    template <class D>
-    inline void xselection_container<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(_titles(), state["_titles"], buffers);
-        xwidgets_serialize(selected_index(), state["selected_index"], buffers);
-    }
-
     template <class D>
     inline void xselection_container<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -32,7 +32,6 @@ namespace xw
         using derived_type = D;
         using options_type = typename base_type::options_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::vector<std::string>, derived_type, tooltips);
@@ -71,7 +70,6 @@ namespace xw
         using options_type = typename base_type::options_type;
         using value_type = typename base_type::value_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::vector<std::string>, derived_type, tooltips);
@@ -99,16 +97,6 @@ namespace xw
      * xselectionslider implementation *
      ***********************************/
 
-    template <class D>
-    inline void xselectionslider<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(orientation(), state["orientation"], buffers);
-        xwidgets_serialize(readout(), state["readout"], buffers);
-        xwidgets_serialize(continuous_update(), state["continuous_update"], buffers);
-    }
-
     template <class D>
     inline void xselectionslider<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -161,16 +149,6 @@ namespace xw
      * xselection_rangeslider implementation *
      *****************************************/
 
-    template <class D>
-    inline void xselection_rangeslider<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(orientation(), state["orientation"], buffers);
-        xwidgets_serialize(readout(), state["readout"], buffers);
-        xwidgets_serialize(continuous_update(), state["continuous_update"], buffers);
-    }
-
     template <class D>
     inline void xselection_rangeslider<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
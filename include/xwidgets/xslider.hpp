@@ -33,7 +33,6 @@ namespace xw
         using base_type = xstyle<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, description_width);
@@ -65,7 +64,6 @@ namespace xw
 
         using value_type = typename base_type::value_type;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(value_type, derived_type, step, value_type(1));
@@ -101,15 +99,6 @@ namespace xw
      * xslider_style implementation *
      ********************************/
 
-    template <class D>
-    inline void xslider_style<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(description_width(), state["description_width"], buffers);
-        xwidgets_serialize(handle_color(), state["handle_color"], buffers);
-    }
-
     template <class D>
     inline void xslider_style<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -138,20 +127,6 @@ namespace xw
      * xslider implementation *
      **************************/
 
-    template <class D>
-    inline void xslider<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(step(), state["step"], buffers);
-        xwidgets_serialize(orientation(), state["orientation"], buffers);
-        xwidgets_serialize(readout(), state["readout"], buffers);
-        xwidgets_serialize(readout_format(), state["readout_format"], buffers);
-        xwidgets_serialize(continuous_update(), state["continuous_update"], buffers);
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-        xwidgets_serialize(style(), state["style"], buffers);
-    }
-
     template <class D>
     inline void xslider<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -27,7 +27,6 @@ namespace xw
         using base_type = xwidget<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, description);
@@ -48,15 +47,6 @@ namespace xw
      * xstring implementation *
      **************************/
 
-    template <class D>
-    inline void xstring<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(value(), state["value"], buffers);
-        xwidgets_serialize(placeholder(), state["placeholder"], buffers);
-    }
-
     template <class D>
     inline void xstring<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
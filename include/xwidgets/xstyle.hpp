@@ -25,7 +25,6 @@ namespace xw
         using base_type = xobject<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
     protected:
@@ -42,12 +41,6 @@ namespace xw
      * base xstyle implementation *
      ******************************/
 
-    template <class D>
-    inline void xstyle<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-    }
-
     template <class D>
     inline void xstyle<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -0,0 +1,100 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_SYNC_POLICY_HPP
+#define XWIDGETS_SYNC_POLICY_HPP
+
+#include <chrono>
+#include <stdexcept>
+
+#include "xwidgets_config.hpp"
+
+namespace xw
+{
+    /****************************
+     * xsync_policy declaration *
+     ****************************/
+
+    enum class xsync_mode
+    {
+        immediate,
+        throttle,
+        debounce
+    };
+
+    /**
+     * Policy applied to the outbound patches of a property.
+     *
+     * - immediate: every change is sent (default).
+     * - throttle: at most one patch is sent per interval, the last value
+     *   of the window being sent on the trailing edge.
+     * - debounce: the last value is sent once the property has not
+     *   changed for the duration of the interval.
+     *
+     * Delayed values are sent on the kernel thread by process_sync_timers,
+     * which a timer posts there at each deadline. See process_sync_timers.
+     *
+     * Unless send_unchanged is set, assigning a property the value that
+     * was last sent to the front-end does not send any message.
+     */
+    struct xsync_policy
+    {
+        using clock_type = std::chrono::steady_clock;
+        using duration_type = clock_type::duration;
+
+        xsync_mode mode = xsync_mode::immediate;
+        duration_type interval = duration_type::zero();
+        bool send_unchanged = false;
+    };
+
+    xsync_policy sync_immediate();
+    xsync_policy sync_throttle(double frequency);
+    template <class R, class P>
+    xsync_policy sync_debounce(std::chrono::duration<R, P> delay);
+
+    /*******************************
+     * xsync_policy implementation *
+     *******************************/
+
+    inline xsync_policy sync_immediate()
+    {
+        return xsync_policy();
+    }
+
+    /**
+     * Throttles the patches of a property at the given frequency (in Hz).
+     */
+    inline xsync_policy sync_throttle(double frequency)
+    {
+        if (!(frequency > 0.))
+        {
+            throw std::invalid_argument("Throttling frequency must be positive");
+        }
+        xsync_policy res;
+        res.mode = xsync_mode::throttle;
+        res.interval = std::chrono::duration_cast<xsync_policy::duration_type>(
+            std::chrono::duration<double>(1. / frequency));
+        return res;
+    }
+
+    /**
+     * Debounces the patches of a property with the given delay.
+     */
+    template <class R, class P>
+    inline xsync_policy sync_debounce(std::chrono::duration<R, P> delay)
+    {
+        xsync_policy res;
+        res.mode = xsync_mode::debounce;
+        res.interval = std::chrono::duration_cast<xsync_policy::duration_type>(delay);
+        return res;
+    }
+}
+
+#define XSYNC_POLICY(O, A, P) O.set_sync_policy(#A, P)
+
+#endif
@@ -9,6 +9,7 @@
 #ifndef XWIDGETS_TEXT_HPP
 #define XWIDGETS_TEXT_HPP
 
+#include "xexecutor.hpp"
 #include "xmaterialize.hpp"
 #include "xstring.hpp"
 
@@ -28,11 +29,18 @@ namespace xw
 
         using submit_callback_type = std::function<void()>;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         void on_submit(submit_callback_type);
 
+        xevent submitted() const;
+
+        using callback_error_type = xcallback_dispatcher::error_handler_type;
+
+        xcallback_mode callback_mode() const;
+        void set_callback_mode(xcallback_mode);
+        void on_callback_error(callback_error_type);
+
         XPROPERTY(bool, derived_type, disabled);
         XPROPERTY(bool, derived_type, continuous_update, true);
 
@@ -48,6 +56,7 @@ namespace xw
         void set_defaults();
 
         std::list<submit_callback_type> m_submit_callbacks;
+        xcallback_dispatcher m_dispatcher;
     };
 
     using text = xmaterialize<xtext>;
@@ -56,15 +65,6 @@ namespace xw
      * xtext implementation *
      ************************/
 
-    template <class D>
-    inline void xtext<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(disabled(), state["disabled"], buffers);
-        xwidgets_serialize(continuous_update(), state["continuous_update"], buffers);
-    }
-
     template <class D>
     inline void xtext<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -80,6 +80,30 @@ namespace xw
         m_submit_callbacks.emplace_back(std::move(cb));
     }
 
+    template <class D>
+    inline xevent xtext<D>::submitted() const
+    {
+        return xevent(*this, "submit");
+    }
+
+    template <class D>
+    inline xcallback_mode xtext<D>::callback_mode() const
+    {
+        return m_dispatcher.mode();
+    }
+
+    template <class D>
+    inline void xtext<D>::set_callback_mode(xcallback_mode mode)
+    {
+        m_dispatcher.set_mode(mode);
+    }
+
+    template <class D>
+    inline void xtext<D>::on_callback_error(callback_error_type handler)
+    {
+        m_dispatcher.set_error_handler(std::move(handler));
+    }
+
     template <class D>
     inline xtext<D>::xtext()
         : base_type()
@@ -100,10 +124,24 @@ namespace xw
         auto it = content.find("event");
         if (it != content.end() && it.value() == "submit")
         {
-            for (auto it = m_submit_callbacks.begin(); it != m_submit_callbacks.end(); ++it)
+            if (m_dispatcher.mode() == xcallback_mode::synchronous)
+            {
+                for (auto it = m_submit_callbacks.begin(); it != m_submit_callbacks.end(); ++it)
+                {
+                    it->operator()();
+                }
+            }
+            else
             {
-                it->operator()();
+                // Callbacks registered later do not apply to this event
+                m_dispatcher.dispatch(this->id(), [callbacks = m_submit_callbacks]() {
+                    for (const auto& callback : callbacks)
+                    {
+                        callback();
+                    }
+                });
             }
+            this->resume_event_waiters("submit");
         }
     }
 
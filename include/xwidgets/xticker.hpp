@@ -0,0 +1,113 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_TICKER_HPP
+#define XWIDGETS_TICKER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "xeus/xguid.hpp"
+
+#include "xholder.hpp"
+#include "xpost.hpp"
+#include "xwidgets_config.hpp"
+
+namespace xw
+{
+    template <class D>
+    class xtransport;
+
+    /**
+     * Frame of a ticker: its index, the number of frames skipped since the
+     * former one, and the time it was due.
+     */
+    struct xtick
+    {
+        std::size_t frame;
+        std::size_t skipped;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    /***********************
+     * xticker declaration *
+     ***********************/
+
+    /**
+     * Clock running a function with a widget at a fixed rate, on the
+     * kernel thread.
+     *
+     * Frames are posted to the kernel thread like the updates made from
+     * other threads (see xpost.hpp). A frame due while the former one has
+     * not been run yet is skipped, so that a slow function or front-end
+     * lowers the frame rate instead of accumulating frames.
+     *
+     * Frames are run when the kernel thread processes the posted tasks. On
+     * a kernel that sets a wakeup (see set_kernel_wakeup), each frame
+     * schedules them in the event loop of the kernel, so that the ticker
+     * runs while the kernel is idle. Otherwise, frames are only run at the
+     * end of the messages received from the front-end and while the kernel
+     * thread waits in process_posted_tasks_until.
+     *
+     * start and stop are called from the kernel thread.
+     */
+    class XWIDGETS_API xticker
+    {
+    public:
+
+        using clock_type = std::chrono::steady_clock;
+        using duration_type = clock_type::duration;
+
+        xticker() = default;
+        ~xticker();
+
+        xticker(const xticker&) = delete;
+        xticker& operator=(const xticker&) = delete;
+
+        template <class D, class F>
+        void start(xtransport<D>& widget, duration_type period, F&& f);
+        void stop();
+
+        bool running() const noexcept;
+        std::size_t frames() const noexcept;
+        std::size_t skipped() const noexcept;
+
+    private:
+
+        using tick_task = std::function<void(xholder&, const xtick&)>;
+
+        struct state;
+
+        void start_impl(const xeus::xguid& id, duration_type period, tick_task&& task);
+        static void run(std::shared_ptr<state> s, xeus::xguid id, duration_type period);
+
+        std::shared_ptr<state> p_state;
+        std::thread m_thread;
+    };
+
+    /**************************
+     * xticker implementation *
+     **************************/
+
+    template <class D, class F>
+    inline void xticker::start(xtransport<D>& widget, duration_type period, F&& f)
+    {
+        // Shared so that move-only functions can be held in std::function
+        auto shared_f = std::make_shared<std::decay_t<F>>(std::forward<F>(f));
+        start_impl(widget.id(), period, [shared_f](xholder& holder, const xtick& tick) {
+            (*shared_f)(holder.template get<D>(), tick);
+        });
+    }
+}
+
+#endif
@@ -29,7 +29,6 @@ namespace xw
         using base_type = xboolean<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, tooltip);
@@ -59,16 +58,6 @@ namespace xw
         set_defaults();
     }
 
-    template <class D>
-    inline void xtogglebutton<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(tooltip(), state["tooltip"], buffers);
-        xwidgets_serialize(icon(), state["icon"], buffers);
-        xwidgets_serialize(button_style(), state["button_style"], buffers);
-    }
-
     template <class D>
     inline void xtogglebutton<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -32,7 +32,6 @@ namespace xw
         using base_type = xstyle<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, button_width);
@@ -62,7 +61,6 @@ namespace xw
         using base_type = xselection<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
     protected:
@@ -90,14 +88,6 @@ namespace xw
      * xtogglebuttons_style implementation *
      ***************************************/
 
-    template <class D>
-    inline void xtogglebuttons_style<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(button_width(), state["button_width"], buffers);
-    }
-
     template <class D>
     inline void xtogglebuttons_style<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -125,17 +115,6 @@ namespace xw
      * xtogglebuttons implementation *
      *********************************/
 
-    template <class D>
-    inline void xtogglebuttons<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(tooltips(), state["tooltips"], buffers);
-        xwidgets_serialize(icons(), state["icons"], buffers);
-        xwidgets_serialize(style(), state["style"], buffers);
-        xwidgets_serialize(button_style(), state["button_style"], buffers);
-    }
-
     template <class D>
     inline void xtogglebuttons<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -9,8 +9,12 @@
 #ifndef XWIDGETS_TRANSPORT_HPP
 #define XWIDGETS_TRANSPORT_HPP
 
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "xeus/xcomm.hpp"
@@ -20,6 +24,8 @@
 
 #include "xcommon.hpp"
 #include "xholder.hpp"
+#include "xpost.hpp"
+#include "xproperty_table.hpp"
 #include "xregistry.hpp"
 #include "xwidgets_config.hpp"
 
@@ -27,15 +33,110 @@ namespace xw
 {
     // Properties
 
+    namespace detail
+    {
+        template <class P>
+        inline void set_property_value(void* property, const nl::json& j, const xeus::buffer_sequence& buffers)
+        {
+            typename P::value_type value;
+            xwidgets_deserialize(value, j, buffers);
+            *static_cast<P*>(property) = std::move(value);
+        }
+
+        inline void ignore_property_value(void*, const nl::json&, const xeus::buffer_sequence&)
+        {
+        }
+
+        // Exposes the message from the front-end being applied to the
+        // widget, so that its values are not sent back. The former message
+        // is restored when the patch has been applied, or has thrown.
+        class xhold_guard
+        {
+        public:
+
+            xhold_guard(const xeus::xmessage*& hold,
+                        const nl::json*& hold_state,
+                        const xeus::xmessage& message,
+                        const nl::json& state) noexcept
+                : m_hold(hold), m_hold_state(hold_state), p_hold(hold), p_hold_state(hold_state)
+            {
+                m_hold = std::addressof(message);
+                m_hold_state = std::addressof(state);
+            }
+
+            ~xhold_guard()
+            {
+                m_hold = p_hold;
+                m_hold_state = p_hold_state;
+            }
+
+            xhold_guard(const xhold_guard&) = delete;
+            xhold_guard& operator=(const xhold_guard&) = delete;
+
+        private:
+
+            const xeus::xmessage*& m_hold;
+            const nl::json*& m_hold_state;
+            const xeus::xmessage* p_hold;
+            const nl::json* p_hold_state;
+        };
+
+        template <class P>
+        inline void serialize_property_value(const void* property, nl::json& j, xeus::buffer_sequence& buffers)
+        {
+            xwidgets_serialize((*static_cast<const P*>(property))(), j, buffers);
+        }
+
+        template <class P>
+        inline const void* get_property_value(const void* property)
+        {
+            return std::addressof((*static_cast<const P*>(property))());
+        }
+
+        template <class P>
+        inline void assign_property_value(void* property, const void* value)
+        {
+            *static_cast<P*>(property) = *static_cast<const typename P::value_type*>(value);
+        }
+    }
+
     template <class P>
     inline void set_property_from_patch(P& property, const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
+        if (xproperty_recorder* recorder = xproperty_recorder::current())
+        {
+            recorder->record(property.name(),
+                             std::addressof(property),
+                             &detail::set_property_value<P>,
+                             &detail::serialize_property_value<P>,
+                             &detail::get_property_value<P>,
+                             &detail::assign_property_value<P>);
+            return;
+        }
+
         auto it = patch.find(property.name());
         if (it != patch.end())
         {
-            typename P::value_type value;
-            xwidgets_deserialize(value, *it, buffers);
-            property = value;
+            detail::set_property_value<P>(std::addressof(property), *it, buffers);
+        }
+    }
+
+    /**
+     * Records a property owned by the kernel: it is serialized in the state
+     * of the widget, while the values received from the front-end are
+     * ignored.
+     */
+    template <class P>
+    inline void set_readonly_property_from_patch(P& property, const nl::json&, const xeus::buffer_sequence&)
+    {
+        if (xproperty_recorder* recorder = xproperty_recorder::current())
+        {
+            recorder->record(property.name(),
+                             std::addressof(property),
+                             &detail::ignore_property_value,
+                             &detail::serialize_property_value<P>,
+                             &detail::get_property_value<P>,
+                             &detail::assign_property_value<P>);
         }
     }
 
@@ -52,7 +153,13 @@ namespace xw
         using derived_type = D;
         using observed_type = xp::xobserved<D>;
 
-        using base_type::notify;
+        template <class T>
+        void notify(const std::string& name, const T& value) const;
+
+        template <class P, class... Args>
+        decltype(auto) invoke_validators(const std::string& name, Args&&... args);
+
+        void invoke_observers(const std::string& name);
 
     protected:
 
@@ -70,6 +177,7 @@ namespace xw
     private:
 
         void handle_message(const xeus::xmessage&);
+        void apply_inbound_patch(const nl::json&, const xeus::buffer_sequence&);
     };
 
     template <class T, class R = void>
@@ -163,6 +271,21 @@ namespace xw
         nl::json state;
         xeus::buffer_sequence buffers;
         this->derived_cast().serialize_state(state, buffers);
+        this->mark_opened();
+
+        // A widget created on another thread is opened on the kernel thread,
+        // which sends the messages of the comms, with the state serialized
+        // here.
+        if (!is_kernel_thread())
+        {
+            using opened_type = std::pair<nl::json, xeus::buffer_sequence>;
+            auto opened = std::make_shared<opened_type>(std::move(state), std::move(buffers));
+            detail::post_task(this->id(), "open", [opened](xholder& holder) {
+                xtransport& self = holder.template get<D>();
+                self.base_type::open(std::move(opened->first), std::move(opened->second));
+            });
+            return;
+        }
 
         // open comm
         base_type::open(std::move(state), std::move(buffers));        
@@ -171,27 +294,41 @@ namespace xw
     template <class D>
     inline void xtransport<D>::close()
     {
+        // Off the kernel thread, the comm is handed over to the kernel thread
+        // to be closed, and the widget is left moved from: it is unregistered
+        // while its id is still available.
+        if (!is_kernel_thread() && !this->moved_from())
+        {
+            get_transport_registry().unregister(this->id());
+        }
         base_type::close();
     }
 
     template <class D>
     inline void xtransport<D>::handle_message(const xeus::xmessage& message)
     {
+        detail::xmessage_scope scope;
         const nl::json& content = message.content();
         const nl::json& data = content["data"];
         const std::string method = data["method"];
 
         if (method == "update")
         {
-            const nl::json& state = data["state"];
             const auto& buffers = message.buffers();
             const nl::json& buffer_paths = data["buffer_paths"];
-            this->hold() = std::addressof(message);;
-            insert_buffer_paths(const_cast<nl::json&>(state), buffer_paths);
-            /*D*/
-            this->derived_cast().apply_patch(state, buffers);
-            /*D*/
-            this->hold() = nullptr;
+            // The received message is left untouched, buffer references are
+            // inserted in a copy of the state only when it has buffers.
+            nl::json patched_state;
+            const nl::json* state = &data["state"];
+            if (!buffer_paths.empty())
+            {
+                patched_state = *state;
+                insert_buffer_paths(patched_state, buffer_paths);
+                state = &patched_state;
+            }
+            detail::xhold_guard guard(this->hold(), this->hold_state(), message, *state);
+            this->reset_sent_state(*state);
+            apply_inbound_patch(*state, buffers);
         }
         else if (method == "request_state")
         {
@@ -200,7 +337,7 @@ namespace xw
             /*D*/
             this->derived_cast().serialize_state(state, buffers);
             /*D*/
-            send_patch(std::move(state), std::move(buffers));
+            this->send_serialized_state(std::move(state), std::move(buffers));
         }
         else if (method == "custom")
         {
@@ -212,6 +349,85 @@ namespace xw
                 /*D*/
             }
         }
+
+        // deliver the deferred patches, and the throttled and debounced
+        // patches that are due
+        flush();
+    }
+
+    template <class D>
+    template <class T>
+    inline void xtransport<D>::notify(const std::string& name, const T& value) const
+    {
+        // Off the kernel thread, the value is sent by the assignment posted
+        // by invoke_validators, or with the state of the widget once opened
+        if (!is_kernel_thread())
+        {
+            return;
+        }
+        base_type::notify(name, value);
+        this->cancel_superseded(name);
+        this->resume_event_waiters(name);
+    }
+
+    template <class D>
+    template <class P, class... Args>
+    inline decltype(auto) xtransport<D>::invoke_validators(const std::string& name, Args&&... args)
+    {
+        // Validators run before the value is stored. Once the widget is
+        // opened, a property assigned from another thread is assigned by a
+        // task posted to the kernel thread, where its validators and its
+        // observers run and its value is sent, and the current value is
+        // stored back meanwhile. The task replaces the pending assignment of
+        // the property, so that the last value assigned wins.
+        if (!is_kernel_thread() && this->opened())
+        {
+            using value_type = std::decay_t<decltype(observed_type::template invoke_validators<P>(name, std::forward<Args>(args)...))>;
+            const xproperty_table::descriptor* property = get_property_table(this->derived_cast()).find(name);
+            if (property == nullptr)
+            {
+                throw std::runtime_error("Property " + name + " is not synchronized and may only be assigned from the kernel thread, use xw::post");
+            }
+            auto value = std::make_shared<value_type>(std::forward<Args>(args)...);
+            std::ptrdiff_t offset = property->offset;
+            xproperty_table::assigner_type assign = property->assigner;
+            detail::post_task(this->id(), "assign/" + name, [value, offset, assign](xholder& holder) {
+                D& widget = holder.template get<D>();
+                assign(reinterpret_cast<char*>(std::addressof(widget)) + offset, value.get());
+            });
+            const char* address = reinterpret_cast<const char*>(std::addressof(this->derived_cast())) + offset;
+            return value_type(*static_cast<const value_type*>(property->getter(address)));
+        }
+        return observed_type::template invoke_validators<P>(name, std::forward<Args>(args)...);
+    }
+
+    template <class D>
+    inline void xtransport<D>::invoke_observers(const std::string& name)
+    {
+        // Observers of the assignments posted from another thread run with
+        // the assignment on the kernel thread
+        if (!is_kernel_thread() && this->opened())
+        {
+            return;
+        }
+        // Observers are also invoked by hand after a change in place, which
+        // is not notified
+        this->mark_state_dirty(name);
+        observed_type::invoke_observers(name);
+    }
+
+    template <class D>
+    inline void xtransport<D>::apply_inbound_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
+    {
+        /*D*/
+        D& widget = this->derived_cast();
+        // Keys unknown to the property table, such as properties with a custom
+        // set_property_from_patch overload, go through the apply_patch chain.
+        if (!get_property_table(widget).apply(std::addressof(widget), patch, buffers))
+        {
+            widget.apply_patch(patch, buffers);
+        }
+        /*D*/
     }
 
     /****************************
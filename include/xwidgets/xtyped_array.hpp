@@ -0,0 +1,476 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_TYPED_ARRAY_HPP
+#define XWIDGETS_TYPED_ARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xmessage.hpp"
+
+#include "xbinary.hpp"
+
+namespace nl = nlohmann;
+
+namespace xw
+{
+    /**********
+     * dtypes *
+     **********/
+
+    /**
+     * Name of the numpy dtype corresponding to the arithmetic type T, such as
+     * "float64" or "uint8". Data is always transmitted in little-endian order.
+     */
+    template <class T>
+    std::string dtype_name();
+
+    /****************************
+     * xtyped_array declaration *
+     ****************************/
+
+    namespace detail
+    {
+        template <class E, class = void>
+        struct has_shape : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_shape<E, decltype(void(std::declval<const E&>().shape()))> : std::true_type
+        {
+        };
+    }
+
+    /**
+     * N-dimensional array of numbers, stored contiguously in row-major order.
+     *
+     * Properties holding an xtyped_array are serialized as a JSON object with
+     * the "dtype" and "shape" of the array, the data being sent as a raw
+     * binary buffer at the "buffer" key. This is the layout expected by the
+     * array serializers of ipydatawidgets. The widget declaring such a
+     * property must add array_buffer_path(name) to its buffer paths.
+     *
+     * xtensor containers (and any expression with a shape() method and
+     * row-major iterators) convert to xtyped_array. Conversely, the data of an
+     * xtyped_array can be adapted with xt::adapt(a.data(), a.size(),
+     * xt::no_ownership(), a.shape()).
+     */
+    template <class T>
+    class xtyped_array
+    {
+    public:
+
+        static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                      "xtyped_array only holds numbers");
+
+        using value_type = T;
+        using storage_type = std::vector<T>;
+        using size_type = std::size_t;
+        using shape_type = std::vector<size_type>;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = typename storage_type::iterator;
+        using const_iterator = typename storage_type::const_iterator;
+
+        xtyped_array();
+        xtyped_array(std::initializer_list<T> values);
+        xtyped_array(storage_type data);
+        explicit xtyped_array(shape_type shape, const T& value = T());
+        xtyped_array(shape_type shape, storage_type data);
+
+        template <class E, class = std::enable_if_t<detail::has_shape<E>::value>>
+        xtyped_array(const E& expression);
+
+        static std::string dtype();
+
+        const shape_type& shape() const noexcept;
+        size_type dimension() const noexcept;
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+        void reshape(shape_type shape);
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+        const storage_type& storage() const noexcept;
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+    private:
+
+        static size_type compute_size(const shape_type& shape);
+
+        shape_type m_shape;
+        storage_type m_data;
+    };
+
+    template <class T>
+    bool operator==(const xtyped_array<T>& lhs, const xtyped_array<T>& rhs);
+
+    template <class T>
+    bool operator!=(const xtyped_array<T>& lhs, const xtyped_array<T>& rhs);
+
+    inline xjson_path_type array_buffer_path(const std::string& name);
+
+    template <class T>
+    void xwidgets_serialize(const xtyped_array<T>& value, nl::json& j, xeus::buffer_sequence& buffers);
+
+    template <class T>
+    void xwidgets_deserialize(xtyped_array<T>& value, const nl::json& j, const xeus::buffer_sequence& buffers);
+
+    /*************************
+     * dtypes implementation *
+     *************************/
+
+    template <class T>
+    inline std::string dtype_name()
+    {
+        static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                      "dtypes are only defined for numbers");
+        const char* kind = std::is_floating_point<T>::value ? "float"
+            : (std::is_signed<T>::value ? "int" : "uint");
+        return kind + std::to_string(8 * sizeof(T));
+    }
+
+    namespace detail
+    {
+        inline bool is_little_endian() noexcept
+        {
+            const std::uint16_t probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        inline void reverse_bytes(char* data, std::size_t item_size, std::size_t count) noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::reverse(data + i * item_size, data + (i + 1) * item_size);
+            }
+        }
+
+        // Little-endian bytes of count items of type T
+        template <class T>
+        inline void write_little_endian(char* dst, const T* src, std::size_t count) noexcept
+        {
+            std::memcpy(dst, src, count * sizeof(T));
+            if (!is_little_endian())
+            {
+                reverse_bytes(dst, sizeof(T), count);
+            }
+        }
+
+        // Reads count little-endian items of type U into dst, converting
+        // them to T.
+        template <class U, class T>
+        inline void read_little_endian(T* dst, const char* src, std::size_t count)
+        {
+            if (std::is_same<T, U>::value)
+            {
+                std::memcpy(dst, src, count * sizeof(T));
+                if (!is_little_endian())
+                {
+                    reverse_bytes(reinterpret_cast<char*>(dst), sizeof(T), count);
+                }
+                return;
+            }
+            const bool swap = !is_little_endian();
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                char bytes[sizeof(U)];
+                std::memcpy(bytes, src + i * sizeof(U), sizeof(U));
+                if (swap)
+                {
+                    std::reverse(bytes, bytes + sizeof(U));
+                }
+                U item;
+                std::memcpy(&item, bytes, sizeof(U));
+                dst[i] = static_cast<T>(item);
+            }
+        }
+
+        template <class U, class T>
+        inline bool read_dtype(const std::string& dtype, T* dst, const char* src, std::size_t count)
+        {
+            if (dtype != dtype_name<U>())
+            {
+                return false;
+            }
+            read_little_endian<U>(dst, src, count);
+            return true;
+        }
+
+        template <class T>
+        inline void read_array_buffer(const std::string& dtype, T* dst, const char* src, std::size_t count)
+        {
+            // The dtype of the property is tried first, then the conversions
+            bool read = read_dtype<T>(dtype, dst, src, count) ||
+                read_dtype<double>(dtype, dst, src, count) ||
+                read_dtype<float>(dtype, dst, src, count) ||
+                read_dtype<std::int8_t>(dtype, dst, src, count) ||
+                read_dtype<std::int16_t>(dtype, dst, src, count) ||
+                read_dtype<std::int32_t>(dtype, dst, src, count) ||
+                read_dtype<std::int64_t>(dtype, dst, src, count) ||
+                read_dtype<std::uint8_t>(dtype, dst, src, count) ||
+                read_dtype<std::uint16_t>(dtype, dst, src, count) ||
+                read_dtype<std::uint32_t>(dtype, dst, src, count) ||
+                read_dtype<std::uint64_t>(dtype, dst, src, count);
+            if (!read)
+            {
+                throw std::runtime_error("xtyped_array: unsupported dtype " + dtype);
+            }
+        }
+
+        inline std::size_t dtype_size(const std::string& dtype)
+        {
+            std::size_t pos = dtype.find_first_of("0123456789");
+            if (pos == std::string::npos)
+            {
+                throw std::runtime_error("xtyped_array: unsupported dtype " + dtype);
+            }
+            return std::stoul(dtype.substr(pos)) / 8;
+        }
+    }
+
+    /*******************************
+     * xtyped_array implementation *
+     *******************************/
+
+    template <class T>
+    inline xtyped_array<T>::xtyped_array()
+        : m_shape{0}, m_data()
+    {
+    }
+
+    template <class T>
+    inline xtyped_array<T>::xtyped_array(std::initializer_list<T> values)
+        : m_shape{values.size()}, m_data(values)
+    {
+    }
+
+    template <class T>
+    inline xtyped_array<T>::xtyped_array(storage_type data)
+        : m_shape{data.size()}, m_data(std::move(data))
+    {
+    }
+
+    template <class T>
+    inline xtyped_array<T>::xtyped_array(shape_type shape, const T& value)
+        : m_shape(std::move(shape)), m_data(compute_size(m_shape), value)
+    {
+    }
+
+    template <class T>
+    inline xtyped_array<T>::xtyped_array(shape_type shape, storage_type data)
+        : m_shape(std::move(shape)), m_data(std::move(data))
+    {
+        if (compute_size(m_shape) != m_data.size())
+        {
+            throw std::invalid_argument("xtyped_array: shape does not match the size of the data");
+        }
+    }
+
+    template <class T>
+    template <class E, class>
+    inline xtyped_array<T>::xtyped_array(const E& expression)
+        : m_shape(expression.shape().cbegin(), expression.shape().cend()),
+          m_data(expression.cbegin(), expression.cend())
+    {
+    }
+
+    template <class T>
+    inline std::string xtyped_array<T>::dtype()
+    {
+        return dtype_name<T>();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::size() const noexcept -> size_type
+    {
+        return m_data.size();
+    }
+
+    template <class T>
+    inline bool xtyped_array<T>::empty() const noexcept
+    {
+        return m_data.empty();
+    }
+
+    template <class T>
+    inline void xtyped_array<T>::reshape(shape_type shape)
+    {
+        if (compute_size(shape) != m_data.size())
+        {
+            throw std::invalid_argument("xtyped_array: shape does not match the size of the data");
+        }
+        m_shape = std::move(shape);
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::data() noexcept -> pointer
+    {
+        return m_data.data();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::data() const noexcept -> const_pointer
+    {
+        return m_data.data();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::storage() const noexcept -> const storage_type&
+    {
+        return m_data;
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::operator[](size_type i) -> reference
+    {
+        return m_data[i];
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::operator[](size_type i) const -> const_reference
+    {
+        return m_data[i];
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::begin() noexcept -> iterator
+    {
+        return m_data.begin();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::end() noexcept -> iterator
+    {
+        return m_data.end();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::begin() const noexcept -> const_iterator
+    {
+        return m_data.cbegin();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::end() const noexcept -> const_iterator
+    {
+        return m_data.cend();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::cbegin() const noexcept -> const_iterator
+    {
+        return m_data.cbegin();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::cend() const noexcept -> const_iterator
+    {
+        return m_data.cend();
+    }
+
+    template <class T>
+    inline auto xtyped_array<T>::compute_size(const shape_type& shape) -> size_type
+    {
+        return std::accumulate(shape.cbegin(), shape.cend(), size_type(1), std::multiplies<size_type>());
+    }
+
+    template <class T>
+    inline bool operator==(const xtyped_array<T>& lhs, const xtyped_array<T>& rhs)
+    {
+        return lhs.shape() == rhs.shape() && lhs.storage() == rhs.storage();
+    }
+
+    template <class T>
+    inline bool operator!=(const xtyped_array<T>& lhs, const xtyped_array<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /*************************************
+     * serialization and deserialization *
+     *************************************/
+
+    inline xjson_path_type array_buffer_path(const std::string& name)
+    {
+        return { name, "buffer" };
+    }
+
+    template <class T>
+    inline void xwidgets_serialize(const xtyped_array<T>& value, nl::json& j, xeus::buffer_sequence& buffers)
+    {
+        j["dtype"] = value.dtype();
+        j["shape"] = value.shape();
+        j["buffer"] = xbuffer_reference_prefix() + std::to_string(buffers.size());
+
+        zmq::message_t buffer(value.size() * sizeof(T));
+        detail::write_little_endian(buffer.data<char>(), value.data(), value.size());
+        buffers.push_back(std::move(buffer));
+    }
+
+    template <class T>
+    inline void xwidgets_deserialize(xtyped_array<T>& value, const nl::json& j, const xeus::buffer_sequence& buffers)
+    {
+        std::string dtype = j.at("dtype").get<std::string>();
+        auto shape = j.at("shape").get<typename xtyped_array<T>::shape_type>();
+        std::size_t index = static_cast<std::size_t>(buffer_index(j.at("buffer").get<std::string>()));
+        const auto& buffer = buffers.at(index);
+
+        xtyped_array<T> res(std::move(shape));
+        if (buffer.size() != res.size() * detail::dtype_size(dtype))
+        {
+            throw std::runtime_error("xtyped_array: buffer size does not match the shape");
+        }
+        // The binary data is read directly into the typed storage
+        detail::read_array_buffer(dtype, res.data(), buffer.data<const char>(), res.size());
+        value = std::move(res);
+    }
+}
+
+#endif
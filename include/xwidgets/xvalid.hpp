@@ -28,7 +28,6 @@ namespace xw
         using base_type = xboolean<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, readout, "Invalid");
@@ -49,14 +48,6 @@ namespace xw
      * xvalid implementation *
      *************************/
 
-    template <class D>
-    inline void xvalid<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(readout(), state["readout"], buffers);
-    }
-
     template <class D>
     inline void xvalid<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
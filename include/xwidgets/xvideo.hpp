@@ -30,7 +30,6 @@ namespace xw
         using base_type = xmedia<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json& state, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(std::string, derived_type, format, "mp4");
@@ -56,19 +55,6 @@ namespace xw
      * xvideo implementation *
      *************************/
 
-    template <class D>
-    inline void xvideo<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(format(), state["format"], buffers);
-        xwidgets_serialize(width(), state["width"], buffers);
-        xwidgets_serialize(height(), state["height"], buffers);
-        xwidgets_serialize(autoplay(), state["autoplay"], buffers);
-        xwidgets_serialize(loop(), state["loop"], buffers);
-        xwidgets_serialize(controls(), state["controls"], buffers);
-    }
-
     template <class D>
     inline void xvideo<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
@@ -96,25 +82,6 @@ namespace xw
         this->_view_name() = "VideoView";
     }
 
-    /**********************
-     * custom serializers *
-     **********************/
-
-    inline void set_property_from_patch(decltype(video::value)& property,
-                                        const nl::json& patch,
-                                        const xeus::buffer_sequence& buffers)
-    {
-        auto it = patch.find(property.name());
-        if (it != patch.end())
-        {
-            using value_type = typename decltype(video::value)::value_type;
-            std::size_t index = buffer_index(patch[property.name()].template get<std::string>());
-            const auto& value_buffer = buffers[index];
-            const char* value_buf = value_buffer.data<const char>();
-            property = value_type(value_buf, value_buf + value_buffer.size());
-        }
-    }
-
     inline auto video_from_file(const std::string& filename)
     {
         return video::initialize().value(read_file(filename));
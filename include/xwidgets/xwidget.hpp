@@ -29,7 +29,6 @@ namespace xw
         using base_type = xobject<D>;
         using derived_type = D;
 
-        void serialize_state(nl::json&, xeus::buffer_sequence&) const;
         void apply_patch(const nl::json&, const xeus::buffer_sequence&);
 
         XPROPERTY(::xw::layout, derived_type, layout);
@@ -56,15 +55,6 @@ namespace xw
         set_defaults();
     }
 
-    template <class D>
-    inline void xwidget<D>::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
-    {
-        base_type::serialize_state(state, buffers);
-
-        xwidgets_serialize(layout(), state["layout"], buffers);
-        xwidgets_serialize(_dom_classes(), state["_dom_classes"], buffers);
-    }
-
     template <class D>
     inline void xwidget<D>::apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
     {
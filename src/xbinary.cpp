@@ -8,6 +8,10 @@
 
 #include "xwidgets/xbinary.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
 namespace nl = nlohmann;
 
 namespace xw
@@ -25,108 +29,491 @@ namespace xw
             std::equal(prefix.cbegin(), prefix.cend(), arg.cbegin());
     }
 
+    namespace detail
+    {
+        // Parses a non-empty sequence of decimal digits, without allocating
+        bool parse_index(const char* first, const char* last, std::size_t& index)
+        {
+            if (first == last)
+            {
+                return false;
+            }
+            std::size_t res = 0;
+            for (; first != last; ++first)
+            {
+                if (*first < '0' || *first > '9')
+                {
+                    return false;
+                }
+                res = res * 10 + static_cast<std::size_t>(*first - '0');
+            }
+            index = res;
+            return true;
+        }
+    }
+
     int buffer_index(const std::string& v)
     {
-        std::stringstream stream(v);
-        stream.ignore(xbuffer_reference_prefix().size());
-        int index = 0;
-        stream >> index;
-        return index;
+        const char* first = v.data() + std::min(v.size(), xbuffer_reference_prefix().size());
+        const char* last = first;
+        while (last != v.data() + v.size() && *last >= '0' && *last <= '9')
+        {
+            ++last;
+        }
+        std::size_t index = 0;
+        detail::parse_index(first, last, index);
+        return static_cast<int>(index);
     }
 
+    /***************
+     * buffer hash *
+     ***************/
+
     namespace detail
     {
-        const nl::json* get_buffers(const nl::json& patch,
-                                    const xjson_path_type& path)
+        // 64-bit xxHash (XXH64)
+        constexpr std::uint64_t xxh_prime1 = 0x9E3779B185EBCA87ULL;
+        constexpr std::uint64_t xxh_prime2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr std::uint64_t xxh_prime3 = 0x165667B19E3779F9ULL;
+        constexpr std::uint64_t xxh_prime4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr std::uint64_t xxh_prime5 = 0x27D4EB2F165667C5ULL;
+
+        inline std::uint64_t xxh_rotl(std::uint64_t x, int r)
         {
-            const nl::json* current = &patch;
-            for (const auto& item : path)
+            return (x << r) | (x >> (64 - r));
+        }
+
+        inline std::uint64_t xxh_read64(const unsigned char* p)
+        {
+            std::uint64_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        inline std::uint32_t xxh_read32(const unsigned char* p)
+        {
+            std::uint32_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        inline std::uint64_t xxh_round(std::uint64_t acc, std::uint64_t input)
+        {
+            acc += input * xxh_prime2;
+            acc = xxh_rotl(acc, 31);
+            return acc * xxh_prime1;
+        }
+
+        inline std::uint64_t xxh_merge_round(std::uint64_t acc, std::uint64_t val)
+        {
+            acc ^= xxh_round(0, val);
+            return acc * xxh_prime1 + xxh_prime4;
+        }
+
+        inline std::size_t hash_combine(std::size_t seed, std::size_t value)
+        {
+            return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+        }
+    }
+
+    std::uint64_t buffer_hash(const void* data, std::size_t size, std::uint64_t seed)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const unsigned char* const end = p + size;
+        std::uint64_t h;
+
+        if (size >= 32)
+        {
+            // Four independent lanes, processed in parallel by the CPU
+            const unsigned char* const limit = end - 32;
+            std::uint64_t v1 = seed + detail::xxh_prime1 + detail::xxh_prime2;
+            std::uint64_t v2 = seed + detail::xxh_prime2;
+            std::uint64_t v3 = seed;
+            std::uint64_t v4 = seed - detail::xxh_prime1;
+            do
             {
-                if (current->is_array())
-                {
-                    current = &(*current)[std::stoul(item)];
-                }
-                else
+                v1 = detail::xxh_round(v1, detail::xxh_read64(p));
+                v2 = detail::xxh_round(v2, detail::xxh_read64(p + 8));
+                v3 = detail::xxh_round(v3, detail::xxh_read64(p + 16));
+                v4 = detail::xxh_round(v4, detail::xxh_read64(p + 24));
+                p += 32;
+            }
+            while (p <= limit);
+
+            h = detail::xxh_rotl(v1, 1) + detail::xxh_rotl(v2, 7) + detail::xxh_rotl(v3, 12) + detail::xxh_rotl(v4, 18);
+            h = detail::xxh_merge_round(h, v1);
+            h = detail::xxh_merge_round(h, v2);
+            h = detail::xxh_merge_round(h, v3);
+            h = detail::xxh_merge_round(h, v4);
+        }
+        else
+        {
+            h = seed + detail::xxh_prime5;
+        }
+
+        h += static_cast<std::uint64_t>(size);
+
+        for (; p + 8 <= end; p += 8)
+        {
+            h ^= detail::xxh_round(0, detail::xxh_read64(p));
+            h = detail::xxh_rotl(h, 27) * detail::xxh_prime1 + detail::xxh_prime4;
+        }
+        if (p + 4 <= end)
+        {
+            h ^= static_cast<std::uint64_t>(detail::xxh_read32(p)) * detail::xxh_prime1;
+            h = detail::xxh_rotl(h, 23) * detail::xxh_prime2 + detail::xxh_prime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            h ^= static_cast<std::uint64_t>(*p) * detail::xxh_prime5;
+            h = detail::xxh_rotl(h, 11) * detail::xxh_prime1;
+        }
+
+        h ^= h >> 33;
+        h *= detail::xxh_prime2;
+        h ^= h >> 29;
+        h *= detail::xxh_prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    bool same_buffer(const void* lhs_data, std::size_t lhs_size,
+                     const void* rhs_data, std::size_t rhs_size)
+    {
+        // memcmp is vectorized by the standard library and exits on the
+        // first difference, which is cheaper than hashing both buffers.
+        return lhs_size == rhs_size &&
+            (lhs_data == rhs_data || lhs_size == 0 || std::memcmp(lhs_data, rhs_data, lhs_size) == 0);
+    }
+
+    /****************************
+     * patch entries comparison *
+     ****************************/
+
+    namespace detail
+    {
+        const zmq::message_t* referenced_buffer(const nl::json& j, const xeus::buffer_sequence& buffers)
+        {
+            if (j.is_string())
+            {
+                const std::string& s = j.get_ref<const std::string&>();
+                if (is_buffer_reference(s))
                 {
-                    auto el = current->find(item);
-                    if (el != current->end())
-                    {
-                        current = &(*el);
-                    }
-                    else
+                    std::size_t index = static_cast<std::size_t>(buffer_index(s));
+                    if (index < buffers.size())
                     {
-                        return nullptr;
+                        return &buffers[index];
                     }
                 }
             }
-            return current;
+            return nullptr;
         }
+    }
 
-        nl::json* get_json(nl::json& patch, const xjson_path_type& path)
+    std::size_t patch_entry_hash(const nl::json& entry, const xeus::buffer_sequence& buffers)
+    {
+        if (buffers.empty())
         {
-            nl::json* current = &patch;
-            for (const auto& item : path)
+            return std::hash<nl::json>()(entry);
+        }
+
+        if (const zmq::message_t* buffer = detail::referenced_buffer(entry, buffers))
+        {
+            // Buffer references depend on the position of the buffer in the
+            // patch, hash the content of the buffer instead.
+            return static_cast<std::size_t>(buffer_hash(buffer->data(), buffer->size()));
+        }
+        else if (entry.is_object())
+        {
+            std::size_t seed = entry.size();
+            for (auto it = entry.cbegin(); it != entry.cend(); ++it)
             {
-                if (current->is_array())
+                seed = detail::hash_combine(seed, std::hash<std::string>()(it.key()));
+                seed = detail::hash_combine(seed, patch_entry_hash(it.value(), buffers));
+            }
+            return seed;
+        }
+        else if (entry.is_array())
+        {
+            std::size_t seed = entry.size();
+            for (const auto& item : entry)
+            {
+                seed = detail::hash_combine(seed, patch_entry_hash(item, buffers));
+            }
+            return seed;
+        }
+        else
+        {
+            return std::hash<nl::json>()(entry);
+        }
+    }
+
+    bool same_patch_entry(const nl::json& lhs,
+                          const xeus::buffer_sequence& lhs_buffers,
+                          const nl::json& rhs,
+                          const xeus::buffer_sequence& rhs_buffers)
+    {
+        const zmq::message_t* lhs_buffer = detail::referenced_buffer(lhs, lhs_buffers);
+        const zmq::message_t* rhs_buffer = detail::referenced_buffer(rhs, rhs_buffers);
+        if (lhs_buffer != nullptr || rhs_buffer != nullptr)
+        {
+            return lhs_buffer != nullptr && rhs_buffer != nullptr &&
+                same_buffer(lhs_buffer->data(), lhs_buffer->size(), rhs_buffer->data(), rhs_buffer->size());
+        }
+        else if (lhs.is_object() && rhs.is_object())
+        {
+            if (lhs.size() != rhs.size())
+            {
+                return false;
+            }
+            for (auto it = lhs.cbegin(); it != lhs.cend(); ++it)
+            {
+                auto rit = rhs.find(it.key());
+                if (rit == rhs.cend() || !same_patch_entry(it.value(), lhs_buffers, *rit, rhs_buffers))
                 {
-                    current = &(*current)[std::stoul(item)];
+                    return false;
                 }
-                else
+            }
+            return true;
+        }
+        else if (lhs.is_array() && rhs.is_array())
+        {
+            if (lhs.size() != rhs.size())
+            {
+                return false;
+            }
+            for (std::size_t i = 0; i != lhs.size(); ++i)
+            {
+                if (!same_patch_entry(lhs[i], lhs_buffers, rhs[i], rhs_buffers))
                 {
-                    current = &(*current)[item];
+                    return false;
                 }
             }
-            return current;
+            return true;
+        }
+        else
+        {
+            return lhs == rhs;
         }
+    }
+
+    /********************************
+     * xbuffer_paths implementation *
+     ********************************/
 
-        template <class T>
-        void set_json(nl::json& patch,
-                      const xjson_path_type& path,
-                      const T& value)
+    xbuffer_paths::xbuffer_paths(std::initializer_list<xjson_path_type> paths)
+    {
+        for (const auto& path : paths)
         {
-            nl::json* json = get_json(patch, path);
-            if (json != nullptr)
+            push_back(path);
+        }
+    }
+
+    xbuffer_paths::xbuffer_paths(const std::vector<xjson_path_type>& paths)
+    {
+        for (const auto& path : paths)
+        {
+            push_back(path);
+        }
+    }
+
+    void xbuffer_paths::push_back(const xjson_path_type& path)
+    {
+        for (const auto& item : path)
+        {
+            std::size_t index = static_cast<std::size_t>(-1);
+            detail::parse_index(item.data(), item.data() + item.size(), index);
+            m_steps.push_back({item, index, item == "*"});
+        }
+        m_ends.push_back(m_steps.size());
+    }
+
+    bool xbuffer_paths::empty() const noexcept
+    {
+        return m_ends.empty();
+    }
+
+    std::size_t xbuffer_paths::size() const noexcept
+    {
+        return m_ends.size();
+    }
+
+    bool xbuffer_paths::contains(const std::string& name) const noexcept
+    {
+        // Whether a path starts in the value of the property name
+        std::size_t begin = 0;
+        for (std::size_t end : m_ends)
+        {
+            if (begin != end && (m_steps[begin].wildcard || m_steps[begin].key == name))
             {
-                (*json) = value;
+                return true;
             }
+            begin = end;
+        }
+        return false;
+    }
+
+    void xbuffer_paths::extract(const nl::json& patch,
+                                const xeus::buffer_sequence& buffers,
+                                nl::json& buffer_paths) const
+    {
+        buffer_paths = nl::json::array();
+        if (buffers.empty())
+        {
+            return;
         }
 
-        void insert_buffer_path(nl::json& patch,
-                                const nl::json& path,
-                                std::size_t buffer_index)
+        buffer_paths = nl::json(buffers.size(), nullptr);
+        std::vector<choice> choices;
+        const step* begin = m_steps.data();
+        for (std::size_t end_index : m_ends)
         {
-            xjson_path_type p = path;
-            detail::set_json(patch, p,
-                xbuffer_reference_prefix() + std::to_string(buffer_index));
+            const step* end = m_steps.data() + end_index;
+            extract_path(begin, begin, end, patch, choices, buffer_paths);
+            begin = end;
         }
     }
 
-    void extract_buffer_paths(const std::vector<xjson_path_type>& to_check,
-                              const nl::json& patch,
-                              const xeus::buffer_sequence& buffers,
-                              nl::json& buffer_paths)
+    void xbuffer_paths::extract_path(const step* first,
+                                     const step* begin,
+                                     const step* end,
+                                     const nl::json& node,
+                                     std::vector<choice>& choices,
+                                     nl::json& buffer_paths) const
     {
-        buffer_paths = nl::json(buffers.size(), nullptr);
-        for (const auto& path : to_check)
+        const nl::json* current = &node;
+        for (; first != end; ++first)
         {
-            const nl::json* item = detail::get_buffers(patch, path);
-            if (item != nullptr && item->is_string())
+            if (first->wildcard)
+            {
+                // The items matched by the wildcard are recorded in choices,
+                // so that the path of a buffer is only built once found.
+                if (current->is_array())
+                {
+                    for (std::size_t i = 0; i != current->size(); ++i)
+                    {
+                        choices.push_back({i, nullptr});
+                        extract_path(first + 1, begin, end, (*current)[i], choices, buffer_paths);
+                        choices.pop_back();
+                    }
+                }
+                else if (current->is_object())
+                {
+                    for (auto it = current->cbegin(); it != current->cend(); ++it)
+                    {
+                        choices.push_back({0, &it.key()});
+                        extract_path(first + 1, begin, end, it.value(), choices, buffer_paths);
+                        choices.pop_back();
+                    }
+                }
+                return;
+            }
+            else if (current->is_array())
+            {
+                if (first->index >= current->size())
+                {
+                    return;
+                }
+                current = &(*current)[first->index];
+            }
+            else if (current->is_object())
             {
-                const std::string leaf = item->get<std::string>();
-                if (is_buffer_reference(leaf))
+                auto it = current->find(first->key);
+                if (it == current->end())
                 {
-                    buffer_paths[buffer_index(leaf)] = path;
+                    return;
                 }
+                current = &(*it);
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        if (!current->is_string())
+        {
+            return;
+        }
+        const std::string& leaf = current->get_ref<const std::string&>();
+        if (!is_buffer_reference(leaf))
+        {
+            return;
+        }
+        std::size_t index = static_cast<std::size_t>(buffer_index(leaf));
+        if (index >= buffer_paths.size())
+        {
+            return;
+        }
+
+        nl::json& path = buffer_paths[index];
+        path = nl::json::array();
+        auto c = choices.cbegin();
+        for (const step* s = begin; s != end; ++s)
+        {
+            if (!s->wildcard)
+            {
+                path.push_back(s->key);
+            }
+            else if (c->key != nullptr)
+            {
+                path.push_back(*(c++)->key);
+            }
+            else
+            {
+                path.push_back((c++)->index);
             }
         }
     }
 
+    void extract_buffer_paths(const xbuffer_paths& to_check,
+                              const nl::json& patch,
+                              const xeus::buffer_sequence& buffers,
+                              nl::json& buffer_paths)
+    {
+        to_check.extract(patch, buffers, buffer_paths);
+    }
+
     void insert_buffer_paths(nl::json& patch,
                              const nl::json& buffer_paths)
     {
+        // Paths received from the front-end hold keys and integer indices
+        std::string reference = xbuffer_reference_prefix();
+        const std::size_t prefix_size = reference.size();
         for (std::size_t i = 0; i != buffer_paths.size(); ++i)
         {
-            detail::insert_buffer_path(patch, buffer_paths[i], i);
+            const nl::json& path = buffer_paths[i];
+            if (!path.is_array())
+            {
+                continue;
+            }
+
+            nl::json* current = &patch;
+            for (const auto& item : path)
+            {
+                if (item.is_number())
+                {
+                    current = &(*current)[item.get<std::size_t>()];
+                }
+                else
+                {
+                    const std::string& key = item.get_ref<const std::string&>();
+                    std::size_t index = 0;
+                    if (current->is_array() && detail::parse_index(key.data(), key.data() + key.size(), index))
+                    {
+                        current = &(*current)[index];
+                    }
+                    else
+                    {
+                        current = &(*current)[key];
+                    }
+                }
+            }
+
+            reference.resize(prefix_size);
+            reference += std::to_string(i);
+            *current = reference;
         }
     }
 }
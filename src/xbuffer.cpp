@@ -0,0 +1,118 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <memory>
+#include <utility>
+
+#include "xwidgets/xbinary.hpp"
+#include "xwidgets/xbuffer.hpp"
+
+namespace xw
+{
+    namespace detail
+    {
+        // Called by zmq once the message does not need the data anymore,
+        // possibly from the I/O thread.
+        void release_buffer_owner(void*, void* hint)
+        {
+            delete static_cast<std::shared_ptr<const void>*>(hint);
+        }
+
+        const char* empty_buffer_data()
+        {
+            static const char data = '\0';
+            return &data;
+        }
+    }
+
+    /**************************
+     * xbuffer implementation *
+     **************************/
+
+    xbuffer::xbuffer() noexcept
+        : p_owner(), p_data(detail::empty_buffer_data()), m_size(0)
+    {
+    }
+
+    xbuffer::xbuffer(std::vector<char>&& data)
+        : xbuffer()
+    {
+        if (!data.empty())
+        {
+            auto storage = std::make_shared<const std::vector<char>>(std::move(data));
+            p_data = storage->data();
+            m_size = storage->size();
+            p_owner = std::move(storage);
+        }
+    }
+
+    xbuffer::xbuffer(const std::vector<char>& data)
+        : xbuffer(std::vector<char>(data))
+    {
+    }
+
+    xbuffer::xbuffer(const char* first, const char* last)
+        : xbuffer(std::vector<char>(first, last))
+    {
+    }
+
+    xbuffer::xbuffer(std::shared_ptr<const void> owner, const char* data, size_type size) noexcept
+        : p_owner(std::move(owner)), p_data(size != 0 ? data : detail::empty_buffer_data()), m_size(size)
+    {
+    }
+
+    xbuffer::xbuffer(const zmq::message_t& message)
+        : xbuffer()
+    {
+        if (message.size() != 0)
+        {
+            // zmq_msg_copy shares the content of the message and only updates
+            // its reference count, hence the const_cast.
+            auto storage = std::make_shared<zmq::message_t>();
+            storage->copy(const_cast<zmq::message_t&>(message));
+            p_data = storage->data<const char>();
+            m_size = storage->size();
+            p_owner = std::move(storage);
+        }
+    }
+
+    zmq::message_t xbuffer::message() const
+    {
+        if (m_size == 0)
+        {
+            return zmq::message_t();
+        }
+        // The message shares the ownership of the storage instead of copying it
+        std::unique_ptr<std::shared_ptr<const void>> hint(new std::shared_ptr<const void>(p_owner));
+        zmq::message_t res(const_cast<char*>(p_data), m_size, &detail::release_buffer_owner, hint.get());
+        hint.release();
+        return res;
+    }
+
+    bool operator==(const xbuffer& lhs, const xbuffer& rhs)
+    {
+        return same_buffer(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+    }
+
+    bool operator!=(const xbuffer& lhs, const xbuffer& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    void xwidgets_serialize(const xbuffer& value, nl::json& j, xeus::buffer_sequence& buffers)
+    {
+        j = xbuffer_reference_prefix() + std::to_string(buffers.size());
+        buffers.push_back(value.message());
+    }
+
+    void xwidgets_deserialize(xbuffer& value, const nl::json& j, const xeus::buffer_sequence& buffers)
+    {
+        std::size_t index = static_cast<std::size_t>(buffer_index(j.get<std::string>()));
+        value = xbuffer(buffers[index]);
+    }
+}
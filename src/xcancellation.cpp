@@ -0,0 +1,56 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <utility>
+
+#include "xwidgets/xcancellation.hpp"
+
+namespace xw
+{
+    /**************************************
+     * xcancellation_token implementation *
+     **************************************/
+
+    xcancellation_token::xcancellation_token(std::shared_ptr<const std::atomic<bool>> flag) noexcept
+        : p_flag(std::move(flag))
+    {
+    }
+
+    bool xcancellation_token::cancelled() const noexcept
+    {
+        return p_flag != nullptr && p_flag->load(std::memory_order_acquire);
+    }
+
+    void xcancellation_token::throw_if_cancelled() const
+    {
+        if (cancelled())
+        {
+            throw xcancelled();
+        }
+    }
+
+    /***************************************
+     * xcancellation_source implementation *
+     ***************************************/
+
+    xcancellation_source::xcancellation_source()
+        : p_flag(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    xcancellation_token xcancellation_source::token() const noexcept
+    {
+        return xcancellation_token(p_flag);
+    }
+
+    void xcancellation_source::cancel()
+    {
+        p_flag->store(true, std::memory_order_release);
+        p_flag = std::make_shared<std::atomic<bool>>(false);
+    }
+}
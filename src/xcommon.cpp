@@ -1,67 +1,283 @@
 #include "xwidgets/xcommon.hpp"
 
 #include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "xeus/xinterpreter.hpp"
 
+#include "xwidgets/xpost.hpp"
+
 #include "xtarget.hpp"
 
 namespace xw
 {
+    namespace detail
+    {
+        // Set of widgets, guarded by a mutex since widgets may be created
+        // and destroyed from several threads
+        class xwidget_set
+        {
+        public:
+
+            void insert(const xcommon* widget)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_widgets.insert(widget);
+            }
+
+            void erase(const xcommon* widget)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_widgets.erase(widget);
+            }
+
+            void move(const xcommon* from, const xcommon* to)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_widgets.erase(from) != 0)
+                {
+                    m_widgets.insert(to);
+                }
+            }
+
+            bool contains(const xcommon* widget) const
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_widgets.find(widget) != m_widgets.end();
+            }
+
+            std::vector<const xcommon*> widgets() const
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return std::vector<const xcommon*>(m_widgets.cbegin(), m_widgets.cend());
+            }
+
+        private:
+
+            mutable std::mutex m_mutex;
+            std::set<const xcommon*> m_widgets;
+        };
+
+        // Widgets holding a throttled or debounced patch waiting for its deadline
+        xwidget_set& get_sync_timer_registry()
+        {
+            static xwidget_set registry;
+            return registry;
+        }
+
+        // Widgets holding a patch waiting to be flushed
+        xwidget_set& get_held_patch_registry()
+        {
+            static xwidget_set registry;
+            return registry;
+        }
+
+        bool& deferred_sync_flag()
+        {
+            static bool deferred = false;
+            return deferred;
+        }
+
+        // Id of the request during which the deferred patches were held
+        std::string& deferred_sync_request()
+        {
+            static std::string msg_id;
+            return msg_id;
+        }
+
+        // Whether a flush of the deferred patches has been posted
+        bool& deferred_flush_posted()
+        {
+            static bool posted = false;
+            return posted;
+        }
+
+        // Waiters whose event has occurred, to be resumed by a posted task.
+        // Only accessed from the kernel thread.
+        std::deque<xevent_waiter*>& triggered_waiters()
+        {
+            static std::deque<xevent_waiter*> waiters;
+            return waiters;
+        }
+
+        std::size_t& trigger_sequence()
+        {
+            static std::size_t sequence = 0;
+            return sequence;
+        }
+
+        // Number of nested front-end messages being handled
+        std::size_t& message_depth()
+        {
+            static std::size_t depth = 0;
+            return depth;
+        }
+
+        xmessage_scope::xmessage_scope() noexcept
+        {
+            ++message_depth();
+        }
+
+        xmessage_scope::~xmessage_scope()
+        {
+            --message_depth();
+        }
+
+        bool xmessage_scope::active() noexcept
+        {
+            return message_depth() != 0;
+        }
+
+        std::string current_request()
+        {
+            const nl::json& parent_header = xeus::get_interpreter().parent_header();
+            auto it = parent_header.find("msg_id");
+            return it != parent_header.end() && it->is_string() ? it->get<std::string>() : std::string();
+        }
+    }
+
     xcommon::xcommon()
         : m_moved_from(false),
+          m_opened(false),
           m_hold(nullptr),
-          m_comm(get_widget_target(), xeus::new_xguid())
+          m_hold_state(nullptr),
+          m_comm(get_widget_target(), xeus::new_xguid()),
+          m_hold_sync_depth(0),
+          p_waiters(nullptr)
     {
     }
 
     xcommon::~xcommon()
     {
+        for (auto& item : m_cancellation_sources)
+        {
+            item.second.cancel();
+        }
+        cancel_event_waiters();
+        detail::get_sync_timer_registry().erase(this);
+        detail::get_held_patch_registry().erase(this);
     }
 
     xcommon::xcommon(xeus::xcomm&& comm)
         : m_moved_from(false),
+          m_opened(true),
           m_hold(nullptr),
-          m_comm(std::move(comm))
+          m_hold_state(nullptr),
+          m_comm(std::move(comm)),
+          m_hold_sync_depth(0),
+          p_waiters(nullptr)
     {
     }
 
     xcommon::xcommon(const xcommon& other)
         : m_moved_from(false),
+          m_opened(false),
           m_hold(nullptr),
+          m_hold_state(nullptr),
           m_comm(other.m_comm),
-          m_buffer_paths(other.m_buffer_paths)
+          m_buffer_paths(other.m_buffer_paths),
+          m_hold_sync_depth(0),
+          p_waiters(nullptr)
     {
+        for (const auto& item : other.m_sync_states)
+        {
+            m_sync_states[item.first].policy = item.second.policy;
+        }
     }
 
     xcommon::xcommon(xcommon&& other)
         : m_moved_from(false),
+          m_opened(other.m_opened),
           m_hold(nullptr),
+          m_hold_state(nullptr),
           m_comm(std::move(other.m_comm)),
-          m_buffer_paths(std::move(other.m_buffer_paths))
+          m_buffer_paths(std::move(other.m_buffer_paths)),
+          m_hold_sync_depth(0),
+          m_held_patch(std::move(other.m_held_patch)),
+          m_held_buffers(std::move(other.m_held_buffers)),
+          m_sync_states(std::move(other.m_sync_states)),
+          m_sent_hashes(std::move(other.m_sent_hashes)),
+          m_state_cache(std::move(other.m_state_cache)),
+          m_cancellation_sources(std::move(other.m_cancellation_sources)),
+          p_waiters(nullptr)
     {
+        take_event_waiters(other);
         other.m_moved_from = true;
+        other.m_hold_sync_depth = 0;
+        other.m_state_cache.valid = false;
+        detail::get_sync_timer_registry().move(&other, this);
+        detail::get_held_patch_registry().move(&other, this);
+        // The hold_sync guards still refer to the moved-from object
+        if (!deferred_sync())
+        {
+            flush_held_patch();
+        }
     }
 
     xcommon& xcommon::operator=(const xcommon& other)
     {
         m_moved_from = false;
+        m_opened = false;
         m_hold = nullptr;
+        m_hold_state = nullptr;
         m_comm = other.m_comm;
         m_buffer_paths = other.m_buffer_paths;
+        m_held_patch = nl::json();
+        m_held_buffers.clear();
+        detail::get_held_patch_registry().erase(this);
+        clear_sync_states();
+        m_sent_hashes.clear();
+        m_state_cache = xstate_cache();
+        for (const auto& item : other.m_sync_states)
+        {
+            m_sync_states[item.first].policy = item.second.policy;
+        }
         return *this;
     }
 
     xcommon& xcommon::operator=(xcommon&& other)
     {
         other.m_moved_from = true;
+        other.m_hold_sync_depth = 0;
         m_moved_from = false;
+        m_opened = other.m_opened;
         m_hold = nullptr;
+        m_hold_state = nullptr;
         m_comm = std::move(other.m_comm);
         m_buffer_paths = std::move(other.m_buffer_paths);
+        m_held_patch = std::move(other.m_held_patch);
+        m_held_buffers = std::move(other.m_held_buffers);
+        other.m_held_patch = nl::json();
+        other.m_held_buffers.clear();
+        detail::get_held_patch_registry().erase(this);
+        detail::get_held_patch_registry().move(&other, this);
+        detail::get_sync_timer_registry().erase(this);
+        m_sync_states = std::move(other.m_sync_states);
+        other.m_sync_states.clear();
+        m_sent_hashes = std::move(other.m_sent_hashes);
+        other.m_sent_hashes.clear();
+        m_state_cache = std::move(other.m_state_cache);
+        other.m_state_cache = xstate_cache();
+        detail::get_sync_timer_registry().move(&other, this);
+        for (auto& item : m_cancellation_sources)
+        {
+            item.second.cancel();
+        }
+        m_cancellation_sources = std::move(other.m_cancellation_sources);
+        other.m_cancellation_sources.clear();
+        cancel_event_waiters();
+        take_event_waiters(other);
+        if (m_hold_sync_depth == 0 && !deferred_sync())
+        {
+            flush_held_patch();
+        }
         return *this;
     }
 
@@ -129,22 +345,206 @@ namespace xw
         return m_hold;
     }
 
+    const nl::json*& xcommon::hold_state()
+    {
+        return m_hold_state;
+    }
+
+    const nl::json* const& xcommon::hold_state() const
+    {
+        return m_hold_state;
+    }
+
     bool xcommon::moved_from() const noexcept
     {
         return m_moved_from;
     }
 
-    std::vector<xjson_path_type>& xcommon::buffer_paths()
+    bool xcommon::opened() const noexcept
+    {
+        return m_opened;
+    }
+
+    void xcommon::mark_opened() noexcept
+    {
+        m_opened = true;
+    }
+
+    xbuffer_paths& xcommon::buffer_paths()
     {
         return m_buffer_paths;
     }
 
-    const std::vector<xjson_path_type>& xcommon::buffer_paths() const
+    const xbuffer_paths& xcommon::buffer_paths() const
     {
         return m_buffer_paths;
     }
 
+    xcancellation_token xcommon::cancellation_token(const std::string& name) const
+    {
+        return m_cancellation_sources[name].token();
+    }
+
+    void xcommon::cancel_superseded(const std::string& name) const
+    {
+        if (m_cancellation_sources.empty())
+        {
+            return;
+        }
+        auto it = m_cancellation_sources.find(name);
+        if (it != m_cancellation_sources.end())
+        {
+            it->second.cancel();
+        }
+    }
+
+    void xcommon::resume_event_waiters(const std::string& event) const
+    {
+        // The waiters are resumed by a task posted to the kernel thread, once
+        // the code raising the event, such as the observers of a property,
+        // has completed. They stay in the list of the widget until then, so
+        // that they follow its moves and are cancelled with it.
+        bool triggered = false;
+        for (detail::xevent_waiter* waiter = p_waiters; waiter != nullptr; waiter = waiter->next)
+        {
+            if (!waiter->triggered && waiter->event == event)
+            {
+                waiter->triggered = true;
+                waiter->sequence = detail::trigger_sequence()++;
+                detail::triggered_waiters().push_back(waiter);
+                triggered = true;
+            }
+        }
+        if (triggered)
+        {
+            post_resume_task();
+        }
+    }
+
+    void xcommon::resume_triggered_waiters()
+    {
+        // Waiters triggered by the resumed coroutines are left for the next
+        // task. If a coroutine throws, the next task resumes the others.
+        auto& waiters = detail::triggered_waiters();
+        const std::size_t end = detail::trigger_sequence();
+        while (!waiters.empty() && waiters.front()->sequence < end)
+        {
+            if (waiters.size() > 1)
+            {
+                post_resume_task();
+            }
+            detail::xevent_waiter& waiter = *waiters.front();
+            const xcommon* source = waiter.owner;
+            source->remove_event_waiter(waiter);
+            waiter.source = source;
+            waiter.resume(waiter, false);
+        }
+    }
+
+    void xcommon::post_resume_task()
+    {
+        detail::post_task(xeus::xguid(), "resume", [](xholder&) { resume_triggered_waiters(); });
+    }
+
+    void xcommon::add_event_waiter(detail::xevent_waiter& waiter) const
+    {
+        waiter.owner = this;
+        waiter.triggered = false;
+        waiter.source = nullptr;
+        waiter.prev = nullptr;
+        waiter.next = p_waiters;
+        if (p_waiters != nullptr)
+        {
+            p_waiters->prev = &waiter;
+        }
+        p_waiters = &waiter;
+    }
+
+    void xcommon::remove_event_waiter(detail::xevent_waiter& waiter) const
+    {
+        if (waiter.triggered)
+        {
+            auto& waiters = detail::triggered_waiters();
+            waiters.erase(std::find(waiters.begin(), waiters.end(), &waiter));
+            waiter.triggered = false;
+        }
+        if (waiter.prev != nullptr)
+        {
+            waiter.prev->next = waiter.next;
+        }
+        else
+        {
+            p_waiters = waiter.next;
+        }
+        if (waiter.next != nullptr)
+        {
+            waiter.next->prev = waiter.prev;
+        }
+        waiter.owner = nullptr;
+        waiter.prev = nullptr;
+        waiter.next = nullptr;
+    }
+
+    void xcommon::cancel_event_waiters() const
+    {
+        while (p_waiters != nullptr)
+        {
+            detail::xevent_waiter& waiter = *p_waiters;
+            remove_event_waiter(waiter);
+            waiter.resume(waiter, true);
+        }
+    }
+
+    void xcommon::take_event_waiters(const xcommon& other)
+    {
+        p_waiters = other.p_waiters;
+        other.p_waiters = nullptr;
+        for (detail::xevent_waiter* waiter = p_waiters; waiter != nullptr; waiter = waiter->next)
+        {
+            waiter->owner = this;
+        }
+    }
+
+    hold_sync_guard xcommon::hold_sync()
+    {
+        return hold_sync_guard(*this);
+    }
+
     void xcommon::send_patch(nl::json&& patch, xeus::buffer_sequence&& buffers) const
+    {
+        send_state(std::move(patch), std::move(buffers));
+    }
+
+    void xcommon::send_state(nl::json&& state, xeus::buffer_sequence&& buffers) const
+    {
+        // Properties modified in place are sent without being notified
+        for (auto it = state.cbegin(); it != state.cend(); ++it)
+        {
+            mark_state_dirty(it.key());
+        }
+        send_serialized_state(std::move(state), std::move(buffers));
+    }
+
+    void xcommon::send_serialized_state(nl::json&& state, xeus::buffer_sequence&& buffers) const
+    {
+        // The state comes from serialize_state, the cache is up to date
+        record_sent_state(state, buffers);
+        dispatch_patch(std::move(state), std::move(buffers));
+    }
+
+    void xcommon::dispatch_patch(nl::json&& patch, xeus::buffer_sequence&& buffers) const
+    {
+        if (m_hold_sync_depth != 0 || deferred_sync())
+        {
+            hold_patch(std::move(patch), std::move(buffers));
+        }
+        else
+        {
+            send_update(std::move(patch), std::move(buffers));
+        }
+    }
+
+    void xcommon::send_update(nl::json&& patch, xeus::buffer_sequence&& buffers) const
     {
         // extract buffer paths
         auto paths = nl::json::array();
@@ -166,6 +566,9 @@ namespace xw
 
     void xcommon::open(nl::json&& patch, xeus::buffer_sequence&& buffers)
     {
+        m_sent_hashes.clear();
+        record_sent_state(patch, buffers);
+
         // extract buffer paths
         auto paths = nl::json::array();
         extract_buffer_paths(buffer_paths(), patch, buffers, paths);
@@ -186,15 +589,429 @@ namespace xw
 
     void xcommon::close()
     {
+        // drop the patches held for a comm that is going away
+        m_held_patch = nl::json();
+        m_held_buffers.clear();
+        detail::get_held_patch_registry().erase(this);
+        clear_sync_states();
+
+        if (!is_kernel_thread())
+        {
+            // close on the kernel thread, after the open posted for the widget
+            auto comm = std::make_shared<xeus::xcomm>(std::move(m_comm));
+            m_moved_from = true;
+            detail::post_task(xeus::xguid(), std::string(), [comm](xholder&) {
+                comm->close(nl::json::object(), nl::json::object(), xeus::buffer_sequence());
+            });
+            return;
+        }
+
         // close
         m_comm.close(nl::json::object(), nl::json::object(), xeus::buffer_sequence());
     } 
 
+    void xcommon::set_sync_policy(const std::string& name, const xsync_policy& policy)
+    {
+        auto& state = m_sync_states[name];
+        state.policy = policy;
+        if (state.pending && policy.mode == xsync_mode::immediate)
+        {
+            // Do not wait for the deadline of the former policy
+            state.deadline = clock_type::now();
+            process_sync_timer(state.deadline);
+        }
+    }
+
+    xsync_policy xcommon::sync_policy(const std::string& name) const
+    {
+        auto it = m_sync_states.find(name);
+        return it != m_sync_states.end() ? it->second.policy : xsync_policy();
+    }
+
+    void xcommon::notify_patch(const std::string& name, nl::json&& patch, xeus::buffer_sequence&& buffers) const
+    {
+        mark_state_dirty(name);
+
+        if (m_hold != nullptr)
+        {
+            // The held state is the one with the buffer references inserted
+            const auto& hold_state = m_hold_state != nullptr ? *m_hold_state : m_hold->content()["data"]["state"];
+            const auto& hold_buffers = m_hold->buffers();
+
+            auto it = hold_state.find(name);
+            if (it != hold_state.end())
+            {
+                if (same_patch(name, *it, hold_buffers, patch[name], buffers))
+                {
+                    return;
+                }
+            }
+        }
+
+        send_property_patch(name, std::move(patch), std::move(buffers));
+    }
+
+    void xcommon::send_property_patch(const std::string& name,
+                                      nl::json&& patch,
+                                      xeus::buffer_sequence&& buffers) const
+    {
+        process_sync_timers();
+
+        auto it = m_sync_states.find(name);
+        if (it == m_sync_states.end() || !it->second.policy.send_unchanged)
+        {
+            // Skip the values already sent to the front-end. The hash is
+            // recorded here once, the patch is dispatched without hashing
+            // it again.
+            std::size_t hash = patch_entry_hash(patch[name], buffers);
+            auto hit = m_sent_hashes.find(name);
+            if (hit != m_sent_hashes.end() && hit->second == hash)
+            {
+                return;
+            }
+            m_sent_hashes[name] = hash;
+        }
+        else
+        {
+            m_sent_hashes.erase(name);
+        }
+
+        if (it == m_sync_states.end() || it->second.policy.mode == xsync_mode::immediate)
+        {
+            dispatch_patch(std::move(patch), std::move(buffers));
+            return;
+        }
+
+        xsync_state& state = it->second;
+        time_point now = clock_type::now();
+        if (state.policy.mode == xsync_mode::throttle)
+        {
+            if (!state.pending && now - state.last_sent >= state.policy.interval)
+            {
+                // leading edge
+                state.last_sent = now;
+                dispatch_patch(std::move(patch), std::move(buffers));
+                return;
+            }
+            state.deadline = state.last_sent + state.policy.interval;
+        }
+        else
+        {
+            state.deadline = now + state.policy.interval;
+        }
+
+        // Only the latest value of the window is kept
+        state.pending = true;
+        state.patch = std::move(patch);
+        state.buffers = std::move(buffers);
+        detail::get_sync_timer_registry().insert(this);
+
+        // The kernel thread is woken up for the deadline, even if nothing
+        // else happens in the meantime
+        detail::post_task_at(state.deadline, id(), "sync/" + name, [](xholder&) {
+            process_sync_timers();
+        });
+    }
+
+    void xcommon::reset_sent_state(const nl::json& patch)
+    {
+        // The front-end state is the one of the inbound patch
+        for (auto it = patch.cbegin(); it != patch.cend(); ++it)
+        {
+            m_sent_hashes.erase(it.key());
+        }
+    }
+
+    void xcommon::record_sent_state(const nl::json& patch, const xeus::buffer_sequence& buffers) const
+    {
+        for (auto it = patch.cbegin(); it != patch.cend(); ++it)
+        {
+            m_sent_hashes[it.key()] = patch_entry_hash(it.value(), buffers);
+        }
+    }
+
+    void xcommon::serialize_cached_state(const xproperty_table& table,
+                                         const void* widget,
+                                         nl::json& state,
+                                         xeus::buffer_sequence& buffers) const
+    {
+        // The cached state can only be returned as is
+        if (!state.empty() || !buffers.empty())
+        {
+            table.serialize(widget, state, buffers);
+            return;
+        }
+
+        xstate_cache& cache = m_state_cache;
+        if (cache.valid && !cache.dirty.empty())
+        {
+            // Only the changed properties are serialized again. The changes
+            // of properties holding buffers discard the cache, should
+            // another property add buffers, the cache is rebuilt.
+            std::size_t buffer_count = cache.buffers.size();
+            table.serialize(widget, cache.dirty, cache.state, cache.buffers);
+            cache.valid = cache.buffers.size() == buffer_count;
+        }
+        if (!cache.valid)
+        {
+            cache.state = nl::json::object();
+            cache.buffers.clear();
+            table.serialize(widget, cache.state, cache.buffers);
+            cache.valid = true;
+        }
+        cache.dirty.clear();
+
+        // The buffers share the content of the cached ones
+        state = cache.state;
+        buffers.reserve(cache.buffers.size());
+        for (auto& buffer : cache.buffers)
+        {
+            buffers.emplace_back();
+            buffers.back().copy(buffer);
+        }
+    }
+
+    void xcommon::mark_state_dirty(const std::string& name) const
+    {
+        xstate_cache& cache = m_state_cache;
+        if (!cache.valid)
+        {
+            return;
+        }
+        if (m_buffer_paths.contains(name))
+        {
+            // Do not keep the former buffers alive until the next request
+            cache = xstate_cache();
+        }
+        else if (std::find(cache.dirty.cbegin(), cache.dirty.cend(), name) == cache.dirty.cend())
+        {
+            cache.dirty.push_back(name);
+        }
+    }
+
+    void xcommon::process_sync_timer(time_point now) const
+    {
+        bool pending = false;
+        for (auto& item : m_sync_states)
+        {
+            xsync_state& state = item.second;
+            if (state.pending)
+            {
+                if (state.deadline <= now)
+                {
+                    state.pending = false;
+                    state.last_sent = now;
+                    nl::json patch = std::move(state.patch);
+                    xeus::buffer_sequence buffers = std::move(state.buffers);
+                    state.patch = nl::json();
+                    state.buffers.clear();
+                    dispatch_patch(std::move(patch), std::move(buffers));
+                }
+                else
+                {
+                    pending = true;
+                }
+            }
+        }
+        if (!pending)
+        {
+            detail::get_sync_timer_registry().erase(this);
+        }
+    }
+
+    void xcommon::clear_sync_states()
+    {
+        for (auto& item : m_sync_states)
+        {
+            item.second.pending = false;
+            item.second.patch = nl::json();
+            item.second.buffers.clear();
+        }
+        detail::get_sync_timer_registry().erase(this);
+    }
+
+    void process_sync_timers()
+    {
+        auto& registry = detail::get_sync_timer_registry();
+        // Sending a patch may update the registry
+        std::vector<const xcommon*> widgets = registry.widgets();
+        if (widgets.empty())
+        {
+            return;
+        }
+
+        auto now = xsync_policy::clock_type::now();
+        for (const xcommon* widget : widgets)
+        {
+            if (registry.contains(widget))
+            {
+                widget->process_sync_timer(now);
+            }
+        }
+    }
+
+    void xcommon::begin_hold_sync()
+    {
+        ++m_hold_sync_depth;
+    }
+
+    void xcommon::end_hold_sync()
+    {
+        if (m_hold_sync_depth != 0 && --m_hold_sync_depth == 0)
+        {
+            flush_held_patch();
+        }
+    }
+
+    namespace detail
+    {
+        // Shifts the buffer references of a patch entry by offset.
+        void shift_buffer_references(nl::json& j, std::size_t offset)
+        {
+            if (j.is_string())
+            {
+                const std::string& s = j.get_ref<const std::string&>();
+                if (is_buffer_reference(s))
+                {
+                    j = xbuffer_reference_prefix() + std::to_string(std::size_t(buffer_index(s)) + offset);
+                }
+            }
+            else if (j.is_structured())
+            {
+                for (auto& el : j)
+                {
+                    shift_buffer_references(el, offset);
+                }
+            }
+        }
+
+        // Renumbers the buffer references of a patch entry, appending the
+        // referenced buffers to the output buffer sequence.
+        void compact_buffer_references(nl::json& j,
+                                       xeus::buffer_sequence& buffers,
+                                       xeus::buffer_sequence& out)
+        {
+            if (j.is_string())
+            {
+                const std::string& s = j.get_ref<const std::string&>();
+                if (is_buffer_reference(s))
+                {
+                    std::size_t index = std::size_t(buffer_index(s));
+                    j = xbuffer_reference_prefix() + std::to_string(out.size());
+                    out.push_back(std::move(buffers[index]));
+                }
+            }
+            else if (j.is_structured())
+            {
+                for (auto& el : j)
+                {
+                    compact_buffer_references(el, buffers, out);
+                }
+            }
+        }
+    }
+
+    void xcommon::hold_patch(nl::json&& patch, xeus::buffer_sequence&& buffers) const
+    {
+        if (deferred_sync())
+        {
+            // Patches held during a former request are not merged with the new ones
+            std::string request = detail::current_request();
+            if (request != detail::deferred_sync_request())
+            {
+                flush();
+                detail::deferred_sync_request() = std::move(request);
+            }
+
+            // Run after the request by the kernel event loop, which is busy
+            // with the request until then
+            if (!detail::deferred_flush_posted())
+            {
+                detail::deferred_flush_posted() = true;
+                detail::post_task(xeus::xguid(), "flush", [](xholder&) {
+                    flush();
+                });
+            }
+        }
+
+        detail::get_held_patch_registry().insert(this);
+        if (m_held_patch.is_null())
+        {
+            m_held_patch = nl::json::object();
+        }
+
+        // Buffers of overwritten entries are dropped when the patch is flushed
+        std::size_t offset = m_held_buffers.size();
+        for (auto it = patch.begin(); it != patch.end(); ++it)
+        {
+            if (offset != 0)
+            {
+                detail::shift_buffer_references(it.value(), offset);
+            }
+            m_held_patch[it.key()] = std::move(it.value());
+        }
+        std::move(buffers.begin(), buffers.end(), std::back_inserter(m_held_buffers));
+    }
+
+    void xcommon::flush_held_patch() const
+    {
+        detail::get_held_patch_registry().erase(this);
+        if (m_held_patch.empty())
+        {
+            return;
+        }
+
+        nl::json patch = std::move(m_held_patch);
+        xeus::buffer_sequence held_buffers = std::move(m_held_buffers);
+        m_held_patch = nl::json();
+        m_held_buffers.clear();
+
+        xeus::buffer_sequence buffers;
+        if (!held_buffers.empty())
+        {
+            detail::compact_buffer_references(patch, held_buffers, buffers);
+        }
+        send_update(std::move(patch), std::move(buffers));
+    }
+
+    void set_deferred_sync(bool deferred)
+    {
+        bool& flag = detail::deferred_sync_flag();
+        if (flag && !deferred)
+        {
+            flush();
+        }
+        flag = deferred;
+    }
+
+    bool deferred_sync()
+    {
+        return detail::deferred_sync_flag();
+    }
+
+    void flush()
+    {
+        detail::deferred_flush_posted() = false;
+        process_posted_tasks();
+        process_sync_timers();
+
+        auto& registry = detail::get_held_patch_registry();
+        std::vector<const xcommon*> widgets = registry.widgets();
+        for (const xcommon* widget : widgets)
+        {
+            // Widgets in a hold_sync transaction are sent when it ends
+            if (registry.contains(widget) && widget->m_hold_sync_depth == 0)
+            {
+                widget->flush_held_patch();
+            }
+        }
+    }
+
     bool xcommon::same_patch(const std::string& name,
-                                    const nl::json& j1,
-                                    const xeus::buffer_sequence&,
-                                    const nl::json& j2,
-                                    const xeus::buffer_sequence&) const
+                             const nl::json& j1,
+                             const xeus::buffer_sequence& b1,
+                             const nl::json& j2,
+                             const xeus::buffer_sequence& b2) const
     {
         const auto& paths = buffer_paths();
         // For a widget with no binary buffer, compare the patches
@@ -205,20 +1022,83 @@ namespace xw
         else
         {
             // For a property with no binary buffer, compare the patches
-            if (std::find_if(paths.cbegin(), paths.cend(), [name](const auto& v) {
-                return !v.empty() && v[0] == name;
-            }) == paths.cend())
+            if (!paths.contains(name))
             {
                 return j1 == j2;
             }
             else
             {
-                // TODO: handle the comparison of binary buffers.
-                return true;
+                return same_patch_entry(j1, b1, j2, b2);
             }
         }
     }
 
+    /**********************************
+     * hold_sync_guard implementation *
+     **********************************/
+
+    hold_sync_guard::hold_sync_guard(xcommon& widget)
+        : p_widget(&widget)
+    {
+        p_widget->begin_hold_sync();
+    }
+
+    hold_sync_guard::~hold_sync_guard()
+    {
+        if (p_widget != nullptr)
+        {
+            p_widget->end_hold_sync();
+        }
+    }
+
+    hold_sync_guard::hold_sync_guard(hold_sync_guard&& rhs)
+        : p_widget(rhs.p_widget)
+    {
+        rhs.p_widget = nullptr;
+    }
+
+    /*************************
+     * xevent implementation *
+     *************************/
+
+    xevent::xevent(const xcommon& widget, std::string name)
+        : p_widget(&widget), m_name(std::move(name))
+    {
+    }
+
+    const xcommon& xevent::widget() const noexcept
+    {
+        return *p_widget;
+    }
+
+    const std::string& xevent::name() const noexcept
+    {
+        return m_name;
+    }
+
+    void xevent::wait(detail::xevent_waiter& waiter) const
+    {
+        waiter.event = m_name;
+        p_widget->add_event_waiter(waiter);
+    }
+
+    void xevent::cancel(detail::xevent_waiter& waiter)
+    {
+        if (waiter.owner != nullptr)
+        {
+            waiter.owner->remove_event_waiter(waiter);
+            waiter.resume(waiter, true);
+        }
+    }
+
+    void xevent::detach(detail::xevent_waiter& waiter)
+    {
+        if (waiter.owner != nullptr)
+        {
+            waiter.owner->remove_event_waiter(waiter);
+        }
+    }
+
     void to_json(nl::json& j, const xcommon& o)
     {
         j = "IPY_MODEL_" + std::string(o.id());
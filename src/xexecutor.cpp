@@ -0,0 +1,337 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "xwidgets/xcancellation.hpp"
+#include "xwidgets/xexecutor.hpp"
+#include "xwidgets/xpost.hpp"
+#include "xwidgets/xregistry.hpp"
+
+namespace xw
+{
+    /****************************
+     * xexecutor implementation *
+     ****************************/
+
+    namespace
+    {
+        // Executor and index of the worker running on this thread
+        thread_local const void* current_executor = nullptr;
+        thread_local std::size_t current_worker = 0;
+    }
+
+    xexecutor::xexecutor(std::size_t thread_count)
+        : m_next(0), m_pending(0), m_stop(false)
+    {
+        thread_count = std::max(thread_count, std::size_t(1));
+        for (std::size_t i = 0; i != thread_count; ++i)
+        {
+            m_queues.emplace_back(new worker_queue());
+        }
+        for (std::size_t i = 0; i != thread_count; ++i)
+        {
+            m_threads.emplace_back(&xexecutor::run, this, i);
+        }
+    }
+
+    xexecutor::~xexecutor()
+    {
+        // Running tasks complete, queued ones are dropped
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    void xexecutor::submit(task_type task)
+    {
+        std::size_t index = current_executor == this
+            ? current_worker
+            : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+        {
+            std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+            m_queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_pending;
+        }
+        m_condition.notify_one();
+    }
+
+    std::size_t xexecutor::size() const noexcept
+    {
+        return m_threads.size();
+    }
+
+    void xexecutor::run(std::size_t index)
+    {
+        current_executor = this;
+        current_worker = index;
+        task_type task;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stop || m_pending != 0; });
+                if (m_stop)
+                {
+                    return;
+                }
+            }
+            if (pop(index, task))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    --m_pending;
+                }
+                try
+                {
+                    task();
+                }
+                catch (const xcancelled&)
+                {
+                    // Work stopped early since its result is not needed
+                }
+                task = nullptr;
+            }
+            else
+            {
+                // Another worker took the task, and has not yet updated the
+                // count of pending tasks.
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool xexecutor::pop(std::size_t index, task_type& task)
+    {
+        {
+            worker_queue& own = *m_queues[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i != m_queues.size(); ++i)
+        {
+            worker_queue& other = *m_queues[(index + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.tasks.empty())
+            {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    xexecutor& get_callback_executor()
+    {
+        static xexecutor executor(std::thread::hardware_concurrency());
+        return executor;
+    }
+
+    /***************************************
+     * xcallback_dispatcher implementation *
+     ***************************************/
+
+    struct xcallback_dispatcher::state
+    {
+        std::mutex mutex;
+        xcallback_mode mode = xcallback_mode::synchronous;
+        bool busy = false;
+        std::deque<task_type> pending;
+        error_handler_type error_handler;
+    };
+
+    namespace
+    {
+        void report_callback_error(const xcallback_dispatcher::error_handler_type& handler,
+                                   const xeus::xguid& id,
+                                   std::exception_ptr error)
+        {
+            if (handler)
+            {
+                handler(error);
+                return;
+            }
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Exception in a callback of widget " << std::string(id) << ": " << e.what() << std::endl;
+            }
+            catch (...)
+            {
+                std::cerr << "Unknown exception in a callback of widget " << std::string(id) << std::endl;
+            }
+        }
+    }
+
+    xcallback_dispatcher::xcallback_dispatcher()
+        : p_state(std::make_shared<state>())
+    {
+    }
+
+    xcallback_dispatcher::xcallback_dispatcher(const xcallback_dispatcher& rhs)
+        : p_state(std::make_shared<state>())
+    {
+        std::lock_guard<std::mutex> lock(rhs.p_state->mutex);
+        p_state->mode = rhs.p_state->mode;
+        p_state->error_handler = rhs.p_state->error_handler;
+    }
+
+    xcallback_dispatcher& xcallback_dispatcher::operator=(const xcallback_dispatcher& rhs)
+    {
+        xcallback_mode mode;
+        error_handler_type handler;
+        {
+            std::lock_guard<std::mutex> lock(rhs.p_state->mutex);
+            mode = rhs.p_state->mode;
+            handler = rhs.p_state->error_handler;
+        }
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        p_state->mode = mode;
+        p_state->error_handler = std::move(handler);
+        return *this;
+    }
+
+    xcallback_dispatcher::xcallback_dispatcher(xcallback_dispatcher&& rhs)
+        : p_state(std::move(rhs.p_state))
+    {
+        // The running callbacks keep the queue of the moved widget
+        rhs.p_state = std::make_shared<state>();
+    }
+
+    xcallback_dispatcher& xcallback_dispatcher::operator=(xcallback_dispatcher&& rhs)
+    {
+        std::swap(p_state, rhs.p_state);
+        return *this;
+    }
+
+    xcallback_mode xcallback_dispatcher::mode() const
+    {
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        return p_state->mode;
+    }
+
+    void xcallback_dispatcher::set_mode(xcallback_mode mode)
+    {
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        p_state->mode = mode;
+    }
+
+    void xcallback_dispatcher::set_error_handler(error_handler_type handler)
+    {
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        p_state->error_handler = std::move(handler);
+    }
+
+    void xcallback_dispatcher::dispatch(const xeus::xguid& id, task_type task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(p_state->mutex);
+            switch (p_state->mode)
+            {
+            case xcallback_mode::synchronous:
+                break;
+            case xcallback_mode::serialize:
+                if (p_state->busy)
+                {
+                    p_state->pending.push_back(std::move(task));
+                    return;
+                }
+                break;
+            case xcallback_mode::drop_while_busy:
+                if (p_state->busy)
+                {
+                    return;
+                }
+                break;
+            case xcallback_mode::run_latest:
+                if (p_state->busy)
+                {
+                    p_state->pending.clear();
+                    p_state->pending.push_back(std::move(task));
+                    return;
+                }
+                break;
+            }
+            if (p_state->mode != xcallback_mode::synchronous)
+            {
+                p_state->busy = true;
+                get_callback_executor().submit([s = p_state, id, task = std::move(task)]() {
+                    run(s, id, task);
+                });
+                return;
+            }
+        }
+        task();
+    }
+
+    void xcallback_dispatcher::run(std::shared_ptr<state> s, xeus::xguid id, task_type task)
+    {
+        try
+        {
+            task();
+        }
+        catch (const xcancelled&)
+        {
+        }
+        catch (...)
+        {
+            // Reported on the kernel thread, without interrupting the
+            // message or the other tasks being processed there. The task is
+            // not bound to the widget, so that the error is logged even if
+            // the widget has been destroyed meanwhile, while its handler,
+            // which may refer to it, is only called if it is alive.
+            std::exception_ptr error = std::current_exception();
+            error_handler_type handler;
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                handler = s->error_handler;
+            }
+            detail::post_task(xeus::xguid(), std::string(), [handler, id, error](xholder&) {
+                bool alive = get_transport_registry().handle(make_widget_id(id)) != xregistry::npos;
+                report_callback_error(alive ? handler : error_handler_type(), id, error);
+            });
+        }
+
+        task_type next;
+        {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            if (s->pending.empty())
+            {
+                s->busy = false;
+                return;
+            }
+            next = std::move(s->pending.front());
+            s->pending.pop_front();
+        }
+        get_callback_executor().submit([s, id, next = std::move(next)]() {
+            run(s, id, next);
+        });
+    }
+}
@@ -17,18 +17,18 @@ namespace xw
 
     xholder::~xholder()
     {
-        delete p_holder;
+        reset();
     }
 
     xholder::xholder(const xholder& rhs)
-        : p_holder(rhs.p_holder ? rhs.p_holder->clone() : nullptr)
+        : p_holder(rhs.p_holder ? rhs.p_holder->clone(&m_buffer) : nullptr)
     {
     }
 
     xholder::xholder(xholder&& rhs)
-        : p_holder(rhs.p_holder)
+        : p_holder(nullptr)
     {
-        rhs.p_holder = nullptr;
+        move_from(rhs);
     }
 
     xholder& xholder::operator=(const xholder& rhs)
@@ -41,15 +41,27 @@ namespace xw
 
     xholder& xholder::operator=(xholder&& rhs)
     {
-        using std::swap;
-        xholder tmp(std::move(rhs));
-        swap(*this, tmp);
+        if (this != &rhs)
+        {
+            // The former implementation is destroyed last
+            xholder former(std::move(*this));
+            move_from(rhs);
+        }
         return *this;
     }
 
     void xholder::swap(xholder& rhs)
     {
-        std::swap(p_holder, rhs.p_holder);
+        if (!is_inline() && !rhs.is_inline())
+        {
+            std::swap(p_holder, rhs.p_holder);
+        }
+        else
+        {
+            xholder tmp(std::move(rhs));
+            rhs.move_from(*this);
+            move_from(tmp);
+        }
     }
 
     void xholder::display() const
@@ -64,6 +76,12 @@ namespace xw
         return p_holder->id();
     }
 
+    void xholder::serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const
+    {
+        check_holder();
+        p_holder->serialize_state(state, buffers);
+    }
+
     xtl::any xholder::value() &
     {
         check_holder();
@@ -84,6 +102,39 @@ namespace xw
         }
     }
 
+    bool xholder::is_inline() const noexcept
+    {
+        return static_cast<const void*>(p_holder) == static_cast<const void*>(&m_buffer);
+    }
+
+    void xholder::move_from(xholder& rhs) noexcept
+    {
+        // Requires this holder to be empty
+        if (rhs.is_inline())
+        {
+            p_holder = rhs.p_holder->move(&m_buffer);
+            rhs.reset();
+        }
+        else
+        {
+            p_holder = rhs.p_holder;
+            rhs.p_holder = nullptr;
+        }
+    }
+
+    void xholder::reset() noexcept
+    {
+        if (is_inline())
+        {
+            p_holder->~xholder_impl();
+        }
+        else
+        {
+            delete p_holder;
+        }
+        p_holder = nullptr;
+    }
+
     void swap(xholder& lhs, xholder& rhs)
     {
         lhs.swap(rhs);
@@ -20,38 +20,53 @@ namespace xw
 
             xholder_id(xeus::xguid id)
                 : base_type(),
-                  m_id(id)
+                  m_guid(id),
+                  m_id(make_widget_id(id)),
+                  m_handle(xregistry::npos),
+                  m_generation(0),
+                  p_holder(nullptr)
             {
             }
 
             virtual ~xholder_id() = default;
 
-            virtual base_type* clone() const override
+            virtual base_type* clone(void* buffer) const override
             {
+                if (fits_holder_buffer<xholder_id>::value)
+                {
+                    return ::new (buffer) xholder_id(*this);
+                }
                 return new xholder_id(*this);
             }
 
+            virtual base_type* move(void* buffer) noexcept override
+            {
+                return ::new (buffer) xholder_id(std::move(*this));
+            }
+
             virtual void display() const override
             {
-                auto& holder = get_transport_registry().find(m_id);
-                holder.display();
+                resolve().display();
             }
 
             virtual xeus::xguid id() const override
             {
-                auto& holder = get_transport_registry().find(m_id);
-                return holder.id();
+                return m_guid;
+            }
+
+            virtual void serialize_state(nl::json& state, xeus::buffer_sequence& buffers) const override
+            {
+                resolve().serialize_state(state, buffers);
             }
 
             virtual xtl::any value() & override
             {
-                auto& holder = get_transport_registry().find(m_id);
-                return holder.value();
+                return resolve().value();
             }
 
             virtual const xtl::any value() const & override
             {
-                const auto& holder = get_transport_registry().find(m_id);
+                const xholder& holder = resolve();
                 return holder.value();
             }
 
@@ -59,13 +74,42 @@ namespace xw
 
             xholder_id(const xholder_id&) = default;
             xholder_id(xholder_id&&) = default;
-            xeus::xguid m_id;
+
+            xholder& resolve() const
+            {
+                // The cached holder is valid as long as the generation of
+                // its handle is unchanged, that is, until the widget is
+                // moved or unregistered. Like the holders of the registry,
+                // id holders are resolved on the kernel thread.
+                auto& registry = get_transport_registry();
+                if (p_holder == nullptr || registry.generation(m_handle) != m_generation)
+                {
+                    m_handle = registry.handle(m_id);
+                    if (m_handle == xregistry::npos)
+                    {
+                        p_holder = nullptr;
+                        throw std::runtime_error("Could not find specified id in transport registry");
+                    }
+                    m_generation = registry.generation(m_handle);
+                    p_holder = &registry.get(m_handle);
+                }
+                return *p_holder;
+            }
+
+            xeus::xguid m_guid;
+            // Parsed once, the registry being indexed by binary ids
+            xwidget_id m_id;
+            mutable xregistry::handle_type m_handle;
+            mutable xregistry::generation_type m_generation;
+            mutable xholder* p_holder;
         };
     }
 
     xholder make_id_holder(xeus::xguid id)
     {
-        return xholder(new detail::xholder_id(id));
+        xholder res;
+        res.emplace<detail::xholder_id>(id);
+        return res;
     }
 }
 
@@ -0,0 +1,128 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include "xwidgets/xoption_index.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        // Below this number of options, a linear scan is as fast as hashing
+        constexpr std::size_t min_indexed_size = 16;
+    }
+
+    namespace detail
+    {
+        constexpr xoption_index::size_type xoption_index::npos;
+
+        xoption_index::xoption_index()
+            : p_data(nullptr), m_size(0)
+        {
+        }
+
+        void xoption_index::rebuild(const options_type& options)
+        {
+            if (options.size() >= std::numeric_limits<std::uint32_t>::max())
+            {
+                throw std::length_error("Too many options");
+            }
+
+            p_data = options.data();
+            m_size = options.size();
+            m_slots.clear();
+            if (m_size < min_indexed_size)
+            {
+                return;
+            }
+
+            // Load factor at most one half
+            std::size_t capacity = 2 * min_indexed_size;
+            while (capacity < 2 * m_size)
+            {
+                capacity *= 2;
+            }
+            m_slots.assign(capacity, 0);
+
+            const std::size_t mask = capacity - 1;
+            std::hash<std::string> hasher;
+            for (size_type i = 0; i != m_size; ++i)
+            {
+                std::size_t slot = hasher(options[i]) & mask;
+                while (true)
+                {
+                    std::uint32_t position = m_slots[slot];
+                    if (position == 0)
+                    {
+                        m_slots[slot] = static_cast<std::uint32_t>(i + 1);
+                        break;
+                    }
+                    // Duplicated options map to their first position
+                    if (options[position - 1] == options[i])
+                    {
+                        break;
+                    }
+                    slot = (slot + 1) & mask;
+                }
+            }
+        }
+
+        auto xoption_index::find(const options_type& options, const std::string& value) const -> size_type
+        {
+            auto& self = const_cast<xoption_index&>(*this);
+            if (options.data() != p_data || options.size() != m_size)
+            {
+                self.rebuild(options);
+            }
+            size_type position = lookup(options, value);
+            if (position != npos && options[position] == value)
+            {
+                return position;
+            }
+
+            // A miss may come from options modified in place: the index is
+            // rebuilt before the value is reported as missing
+            self.rebuild(options);
+            return lookup(options, value);
+        }
+
+        bool xoption_index::contains(const options_type& options, const std::string& value) const
+        {
+            return find(options, value) != npos;
+        }
+
+        auto xoption_index::lookup(const options_type& options, const std::string& value) const -> size_type
+        {
+            if (m_slots.empty())
+            {
+                auto it = std::find(options.cbegin(), options.cend(), value);
+                return it != options.cend() ? size_type(it - options.cbegin()) : npos;
+            }
+
+            const std::size_t mask = m_slots.size() - 1;
+            std::size_t slot = std::hash<std::string>()(value) & mask;
+            while (true)
+            {
+                std::uint32_t position = m_slots[slot];
+                if (position == 0)
+                {
+                    return npos;
+                }
+                if (options[position - 1] == value)
+                {
+                    return position - 1;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+    }
+}
@@ -0,0 +1,167 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "xwidgets/xoption_store.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        xoption_store::size_type request_size(const nl::json& request, const char* key)
+        {
+            auto it = request.find(key);
+            if (it == request.end() || !it->is_number_integer())
+            {
+                return 0;
+            }
+            std::int64_t value = it->get<std::int64_t>();
+            return value > 0 ? xoption_store::size_type(value) : 0;
+        }
+    }
+
+    constexpr xoption_store::size_type xoption_store::npos;
+    constexpr xoption_store::size_type xoption_store::max_page_size;
+
+    xoption_store::xoption_store()
+    {
+    }
+
+    xoption_store::xoption_store(options_type options)
+    {
+        assign(std::move(options));
+    }
+
+    void xoption_store::assign(options_type options)
+    {
+        if (options.size() >= std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::length_error("Too many options");
+        }
+        m_options = std::move(options);
+        m_index.rebuild(m_options);
+        m_sorted.clear();
+    }
+
+    auto xoption_store::options() const noexcept -> const options_type&
+    {
+        return m_options;
+    }
+
+    auto xoption_store::size() const noexcept -> size_type
+    {
+        return m_options.size();
+    }
+
+    bool xoption_store::empty() const noexcept
+    {
+        return m_options.empty();
+    }
+
+    const std::string& xoption_store::operator[](size_type i) const
+    {
+        return m_options[i];
+    }
+
+    auto xoption_store::find(const std::string& value) const -> size_type
+    {
+        return m_index.find(m_options, value);
+    }
+
+    xoption_page xoption_store::page(size_type offset, size_type count) const
+    {
+        xoption_page res;
+        res.total = m_options.size();
+        res.offset = std::min(offset, res.total);
+        size_type last = res.offset + std::min(count, res.total - res.offset);
+        res.indices.reserve(last - res.offset);
+        for (size_type i = res.offset; i != last; ++i)
+        {
+            res.indices.push_back(i);
+        }
+        return res;
+    }
+
+    xoption_page xoption_store::page(const std::string& prefix, size_type offset, size_type count) const
+    {
+        if (prefix.empty())
+        {
+            return page(offset, count);
+        }
+
+        // The labels starting with prefix are contiguous in sorted order
+        const auto& order = sorted();
+        auto first = std::lower_bound(order.cbegin(), order.cend(), prefix, [this](std::uint32_t i, const std::string& p) {
+            return m_options[i] < p;
+        });
+        auto last = std::partition_point(first, order.cend(), [this, &prefix](std::uint32_t i) {
+            return m_options[i].compare(0, prefix.size(), prefix) == 0;
+        });
+
+        xoption_page res;
+        res.total = size_type(last - first);
+        res.offset = std::min(offset, res.total);
+        auto it = first + res.offset;
+        auto end = it + std::min(count, res.total - res.offset);
+        res.indices.assign(it, end);
+        return res;
+    }
+
+    nl::json xoption_store::reply(const nl::json& request) const
+    {
+        std::string prefix;
+        auto it = request.find("prefix");
+        if (it != request.end() && it->is_string())
+        {
+            prefix = it->get<std::string>();
+        }
+        size_type count = std::min(request_size(request, "count"), max_page_size);
+        xoption_page p = page(prefix, request_size(request, "offset"), count);
+
+        nl::json labels = nl::json::array();
+        for (size_type i : p.indices)
+        {
+            labels.push_back(m_options[i]);
+        }
+
+        nl::json res;
+        res["event"] = "page";
+        it = request.find("request");
+        if (it != request.end())
+        {
+            res["request"] = *it;
+        }
+        res["prefix"] = std::move(prefix);
+        res["offset"] = p.offset;
+        res["total"] = p.total;
+        res["indices"] = std::move(p.indices);
+        res["labels"] = std::move(labels);
+        return res;
+    }
+
+    const std::vector<std::uint32_t>& xoption_store::sorted() const
+    {
+        if (m_sorted.size() != m_options.size())
+        {
+            m_sorted.resize(m_options.size());
+            for (std::size_t i = 0; i != m_sorted.size(); ++i)
+            {
+                m_sorted[i] = static_cast<std::uint32_t>(i);
+            }
+            std::stable_sort(m_sorted.begin(), m_sorted.end(), [this](std::uint32_t lhs, std::uint32_t rhs) {
+                return m_options[lhs] < m_options[rhs];
+            });
+        }
+        return m_sorted;
+    }
+}
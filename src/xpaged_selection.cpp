@@ -0,0 +1,10 @@
+#include "xwidgets/xpaged_selection.hpp"
+
+namespace xw
+{
+    template class XWIDGETS_API xmaterialize<xpaged_select>;
+    template class XWIDGETS_API xtransport<xmaterialize<xpaged_select>>;
+
+    template class XWIDGETS_API xmaterialize<xpaged_dropdown>;
+    template class XWIDGETS_API xtransport<xmaterialize<xpaged_dropdown>>;
+}
@@ -0,0 +1,360 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "xwidgets/xcommon.hpp"
+#include "xwidgets/xpost.hpp"
+#include "xwidgets/xregistry.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        struct xposted
+        {
+            xeus::xguid id;
+            std::string key;
+            detail::posted_task task;
+            xposted* next;
+        };
+
+        std::atomic<std::thread::id>& kernel_thread()
+        {
+            static std::atomic<std::thread::id> id;
+            return id;
+        }
+
+        // Tasks posted from other threads, pushed on a lock-free stack that
+        // the kernel thread takes as a whole.
+        std::atomic<xposted*>& posted_stack()
+        {
+            static std::atomic<xposted*> head(nullptr);
+            return head;
+        }
+
+        // Wakes the kernel thread waiting in process_posted_tasks_until. The
+        // flag spares the posting threads the lock when nobody waits.
+        struct xwakeup
+        {
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::atomic<bool> waiting{false};
+        };
+
+        xwakeup& wakeup()
+        {
+            static xwakeup w;
+            return w;
+        }
+
+        using xkernel_wakeup = std::shared_ptr<const std::function<void()>>;
+
+        // Set by the kernel, read by the posting threads
+        xkernel_wakeup& kernel_wakeup()
+        {
+            static xkernel_wakeup w;
+            return w;
+        }
+
+        // Posts the tasks scheduled by post_task_at once they are due.
+        class xtimer
+        {
+        public:
+
+            using clock_type = std::chrono::steady_clock;
+
+            ~xtimer()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_condition.notify_one();
+                if (m_thread.joinable())
+                {
+                    m_thread.join();
+                }
+            }
+
+            void schedule(clock_type::time_point deadline,
+                          const xeus::xguid& id,
+                          const std::string& key,
+                          detail::posted_task&& task)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_tasks[std::string(id) + '/' + key] = xscheduled{deadline, id, key, std::move(task)};
+                    if (!m_thread.joinable())
+                    {
+                        m_thread = std::thread([this]() { run(); });
+                    }
+                }
+                m_condition.notify_one();
+            }
+
+        private:
+
+            struct xscheduled
+            {
+                clock_type::time_point deadline;
+                xeus::xguid id;
+                std::string key;
+                detail::posted_task task;
+            };
+
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (!m_stopping)
+                {
+                    if (m_tasks.empty())
+                    {
+                        m_condition.wait(lock);
+                        continue;
+                    }
+
+                    // Only a few tasks are scheduled at once
+                    auto next = m_tasks.begin();
+                    for (auto it = m_tasks.begin(); it != m_tasks.end(); ++it)
+                    {
+                        if (it->second.deadline < next->second.deadline)
+                        {
+                            next = it;
+                        }
+                    }
+                    if (clock_type::now() < next->second.deadline)
+                    {
+                        m_condition.wait_until(lock, next->second.deadline);
+                        continue;
+                    }
+
+                    xscheduled task = std::move(next->second);
+                    m_tasks.erase(next);
+                    lock.unlock();
+                    detail::post_task(task.id, task.key, std::move(task.task));
+                    lock.lock();
+                }
+            }
+
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::map<std::string, xscheduled> m_tasks;
+            std::thread m_thread;
+            bool m_stopping = false;
+        };
+
+        xtimer& timer()
+        {
+            // Constructed first so that they outlive the timer thread
+            posted_stack();
+            wakeup();
+            kernel_wakeup();
+            static xtimer t;
+            return t;
+        }
+
+        // Tasks taken from the stack and not run yet, only accessed from
+        // the kernel thread. Keyed tasks are indexed by widget and key, so
+        // that a later task replaces the pending one.
+        struct xpending
+        {
+            std::list<xposted> tasks;
+            std::unordered_map<std::string, std::list<xposted>::iterator> keyed;
+        };
+
+        xpending& pending_tasks()
+        {
+            static xpending pending;
+            return pending;
+        }
+
+        std::string task_key(const xposted& task)
+        {
+            return std::string(task.id) + '/' + task.key;
+        }
+
+        void take_posted_tasks(xpending& pending)
+        {
+            xposted* head = posted_stack().exchange(nullptr, std::memory_order_acquire);
+
+            // The stack holds the tasks in reverse order
+            std::list<xposted> tasks;
+            while (head != nullptr)
+            {
+                std::unique_ptr<xposted> task(head);
+                head = head->next;
+                tasks.push_front(std::move(*task));
+            }
+
+            while (!tasks.empty())
+            {
+                auto it = tasks.begin();
+                if (!it->key.empty())
+                {
+                    std::string key = task_key(*it);
+                    auto kit = pending.keyed.find(key);
+                    if (kit != pending.keyed.end())
+                    {
+                        // Last write wins, at the position of the first one
+                        kit->second->task = std::move(it->task);
+                        tasks.erase(it);
+                        continue;
+                    }
+                    pending.keyed.emplace(std::move(key), it);
+                }
+                pending.tasks.splice(pending.tasks.end(), tasks, it);
+            }
+        }
+    }
+
+    bool is_kernel_thread()
+    {
+        std::thread::id id = kernel_thread().load(std::memory_order_relaxed);
+        return id == std::thread::id() || id == std::this_thread::get_id();
+    }
+
+    void process_posted_tasks()
+    {
+        if (!is_kernel_thread())
+        {
+            return;
+        }
+
+        xpending& pending = pending_tasks();
+        take_posted_tasks(pending);
+
+        auto& registry = get_transport_registry();
+        while (!pending.tasks.empty())
+        {
+            // Removed before running, since a task may process the tasks
+            // itself. If it throws, the next tasks are run by the next call.
+            xposted task = std::move(pending.tasks.front());
+            if (!task.key.empty())
+            {
+                pending.keyed.erase(task_key(task));
+            }
+            pending.tasks.pop_front();
+
+            if (std::string(task.id).empty())
+            {
+                xholder holder;
+                task.task(holder);
+                continue;
+            }
+
+            // Tasks of widgets destroyed in the meantime are dropped
+            auto handle = registry.handle(make_widget_id(task.id));
+            if (handle != xregistry::npos)
+            {
+                task.task(registry.get(handle));
+            }
+        }
+    }
+
+    void process_posted_tasks_until(std::chrono::steady_clock::time_point deadline)
+    {
+        if (!is_kernel_thread())
+        {
+            return;
+        }
+
+        xwakeup& w = wakeup();
+        while (true)
+        {
+            // Also sends the held and throttled patches that are due
+            flush();
+
+            std::unique_lock<std::mutex> lock(w.mutex);
+            w.waiting.store(true);
+            bool posted = w.condition.wait_until(lock, deadline, []() {
+                return posted_stack().load() != nullptr;
+            });
+            w.waiting.store(false);
+            if (!posted)
+            {
+                break;
+            }
+        }
+        flush();
+    }
+
+    void set_kernel_wakeup(std::function<void()> wakeup)
+    {
+        xkernel_wakeup w;
+        if (wakeup)
+        {
+            w = std::make_shared<const std::function<void()>>(std::move(wakeup));
+        }
+        std::atomic_store(&kernel_wakeup(), w);
+        if (w && posted_stack().load() != nullptr)
+        {
+            (*w)();
+        }
+    }
+
+    void set_kernel_thread()
+    {
+        kernel_thread().store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+
+    namespace
+    {
+        // The library is loaded by the interpreter, on the kernel thread
+        const bool kernel_thread_initialized = (set_kernel_thread(), true);
+    }
+
+    namespace detail
+    {
+        void post_task(const xeus::xguid& id, const std::string& key, posted_task&& task)
+        {
+            xposted* node = new xposted{id, key, std::move(task), nullptr};
+            auto& head = posted_stack();
+            // The node belongs to the kernel thread once pushed, next keeps
+            // the former head. Sequentially consistent, to be ordered with
+            // the waiting flag.
+            xposted* next = head.load(std::memory_order_relaxed);
+            do
+            {
+                node->next = next;
+            } while (!head.compare_exchange_weak(next, node));
+            xwakeup& w = wakeup();
+            if (w.waiting.load())
+            {
+                std::lock_guard<std::mutex> lock(w.mutex);
+                w.condition.notify_one();
+            }
+            else if (next == nullptr)
+            {
+                // The kernel has not been woken up for the pending tasks yet
+                xkernel_wakeup kernel_wakeup_fn = std::atomic_load(&kernel_wakeup());
+                if (kernel_wakeup_fn)
+                {
+                    (*kernel_wakeup_fn)();
+                }
+            }
+        }
+
+        void post_task_at(std::chrono::steady_clock::time_point deadline,
+                          const xeus::xguid& id,
+                          const std::string& key,
+                          posted_task&& task)
+        {
+            timer().schedule(deadline, id, key, std::move(task));
+        }
+    }
+}
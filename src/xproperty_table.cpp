@@ -0,0 +1,205 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+
+#include "xwidgets/xbinary.hpp"
+#include "xwidgets/xproperty_table.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        constexpr std::size_t empty_slot = static_cast<std::size_t>(-1);
+    }
+
+    /**********************************
+     * xproperty_table implementation *
+     **********************************/
+
+    void xproperty_table::add(const std::string& name,
+                              std::ptrdiff_t offset,
+                              setter_type setter,
+                              serializer_type serializer,
+                              getter_type getter,
+                              assigner_type assigner)
+    {
+        // A property set twice by the apply_patch chain is applied once, at
+        // its first position.
+        auto it = std::find_if(m_descriptors.cbegin(), m_descriptors.cend(), [&name](const descriptor& d) {
+            return d.name == name;
+        });
+        if (it == m_descriptors.cend())
+        {
+            m_descriptors.push_back({name, offset, setter, serializer, getter, assigner});
+        }
+    }
+
+    void xproperty_table::build()
+    {
+        // Open slots at least twice as many as the entries, and search for a
+        // seed for which the hash of the names has no collision.
+        std::size_t capacity = 1;
+        while (capacity < 2 * m_descriptors.size())
+        {
+            capacity *= 2;
+        }
+
+        for (;;)
+        {
+            m_slots.assign(capacity, empty_slot);
+            for (m_seed = 0; m_seed != 64; ++m_seed)
+            {
+                std::fill(m_slots.begin(), m_slots.end(), empty_slot);
+                bool collision = false;
+                for (std::size_t i = 0; i != m_descriptors.size() && !collision; ++i)
+                {
+                    std::size_t& s = m_slots[slot(m_descriptors[i].name, m_seed)];
+                    collision = s != empty_slot;
+                    s = i;
+                }
+                if (!collision)
+                {
+                    return;
+                }
+            }
+            capacity *= 2;
+        }
+    }
+
+    std::size_t xproperty_table::size() const noexcept
+    {
+        return m_descriptors.size();
+    }
+
+    auto xproperty_table::find(const std::string& name) const noexcept -> const descriptor*
+    {
+        if (m_slots.empty())
+        {
+            return nullptr;
+        }
+        std::size_t index = m_slots[slot(name, m_seed)];
+        if (index != empty_slot && m_descriptors[index].name == name)
+        {
+            return &m_descriptors[index];
+        }
+        return nullptr;
+    }
+
+    bool xproperty_table::apply(void* widget,
+                                const nl::json& patch,
+                                const xeus::buffer_sequence& buffers) const
+    {
+        char* base = static_cast<char*>(widget);
+        if (patch.size() == 1)
+        {
+            auto it = patch.cbegin();
+            const descriptor* d = find(it.key());
+            if (d == nullptr)
+            {
+                return false;
+            }
+            d->setter(base + d->offset, it.value(), buffers);
+            return true;
+        }
+
+        // All the keys are resolved before any property is set, so that a
+        // patch with an unknown key can still be applied by apply_patch.
+        std::vector<std::pair<const descriptor*, const nl::json*>> items;
+        items.reserve(patch.size());
+        for (auto it = patch.cbegin(); it != patch.cend(); ++it)
+        {
+            const descriptor* d = find(it.key());
+            if (d == nullptr)
+            {
+                return false;
+            }
+            items.emplace_back(d, &it.value());
+        }
+
+        // Properties are set in the order of the apply_patch chain, which
+        // observers and validators may depend on.
+        std::sort(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        for (const auto& item : items)
+        {
+            item.first->setter(base + item.first->offset, *item.second, buffers);
+        }
+        return true;
+    }
+
+    void xproperty_table::serialize(const void* widget, nl::json& state, xeus::buffer_sequence& buffers) const
+    {
+        const char* base = static_cast<const char*>(widget);
+        for (const auto& d : m_descriptors)
+        {
+            d.serializer(base + d.offset, state[d.name], buffers);
+        }
+    }
+
+    void xproperty_table::serialize(const void* widget,
+                                    const std::vector<std::string>& names,
+                                    nl::json& state,
+                                    xeus::buffer_sequence& buffers) const
+    {
+        // Names that are not properties of the widget are ignored
+        const char* base = static_cast<const char*>(widget);
+        for (const auto& name : names)
+        {
+            if (const descriptor* d = find(name))
+            {
+                d->serializer(base + d->offset, state[d->name], buffers);
+            }
+        }
+    }
+
+    std::size_t xproperty_table::slot(const std::string& name, std::uint64_t seed) const noexcept
+    {
+        return static_cast<std::size_t>(buffer_hash(name.data(), name.size(), seed)) & (m_slots.size() - 1);
+    }
+
+    /*************************************
+     * xproperty_recorder implementation *
+     *************************************/
+
+    namespace
+    {
+        xproperty_recorder*& current_recorder() noexcept
+        {
+            static thread_local xproperty_recorder* recorder = nullptr;
+            return recorder;
+        }
+    }
+
+    xproperty_recorder::xproperty_recorder(xproperty_table& table, const void* widget)
+        : m_table(table), p_widget(static_cast<const char*>(widget)), p_previous(current_recorder())
+    {
+        current_recorder() = this;
+    }
+
+    xproperty_recorder::~xproperty_recorder()
+    {
+        current_recorder() = p_previous;
+    }
+
+    xproperty_recorder* xproperty_recorder::current() noexcept
+    {
+        return current_recorder();
+    }
+
+    void xproperty_recorder::record(const std::string& name,
+                                    const void* property,
+                                    xproperty_table::setter_type setter,
+                                    xproperty_table::serializer_type serializer,
+                                    xproperty_table::getter_type getter,
+                                    xproperty_table::assigner_type assigner)
+    {
+        m_table.add(name, static_cast<const char*>(property) - p_widget, setter, serializer, getter, assigner);
+    }
+}
@@ -1,25 +1,569 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "xwidgets/xbinary.hpp"
 #include "xwidgets/xregistry.hpp"
 
 namespace xw
 {
+    /*****************************
+     * xwidget_id implementation *
+     *****************************/
+
+    xwidget_id make_widget_id(const xeus::xguid& guid)
+    {
+        const std::string s = guid;
+        xwidget_id res;
+        std::size_t digits = 0;
+        for (char c : s)
+        {
+            std::uint64_t value;
+            if (c >= '0' && c <= '9')
+            {
+                value = static_cast<std::uint64_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                value = static_cast<std::uint64_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                value = static_cast<std::uint64_t>(c - 'A' + 10);
+            }
+            else if (c == '-')
+            {
+                continue;
+            }
+            else
+            {
+                digits = 0;
+                break;
+            }
+            res.high = (res.high << 4) | (res.low >> 60);
+            res.low = (res.low << 4) | value;
+            ++digits;
+        }
+
+        if (digits != 32)
+        {
+            // Ids that are not GUIDs, such as the ones of comms opened by
+            // other front-ends, are hashed.
+            res.high = buffer_hash(s.data(), s.size(), 1);
+            res.low = buffer_hash(s.data(), s.size(), 2);
+        }
+        return res;
+    }
+
+    bool operator==(const xwidget_id& lhs, const xwidget_id& rhs) noexcept
+    {
+        return lhs.high == rhs.high && lhs.low == rhs.low;
+    }
+
+    bool operator!=(const xwidget_id& lhs, const xwidget_id& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /****************************
+     * xregistry implementation *
+     ****************************/
+
+    namespace
+    {
+        constexpr std::size_t shard_bits = 4;
+        constexpr std::size_t shard_count = std::size_t(1) << shard_bits;
+
+        // Chunk k holds 2^(first_chunk_bits + k) entries, so that the
+        // entries of a shard are addressed by a few chunk pointers.
+        constexpr std::size_t first_chunk_bits = 6;
+        constexpr std::size_t max_index = (std::size_t(1) << (32 - shard_bits)) - 1;
+        constexpr std::size_t chunk_count = 32 - shard_bits - first_chunk_bits + 1;
+
+        struct xentry
+        {
+            xwidget_id id;
+            xholder holder;
+            // Odd while a widget is registered
+            std::atomic<std::uint32_t> generation{0};
+        };
+
+        constexpr std::uint32_t empty_slot = static_cast<std::uint32_t>(-1);
+
+        // Slot of the open-addressing table. The fields are read without
+        // the lock of the shard, and validated by its sequence number.
+        struct xslot
+        {
+            std::atomic<std::uint64_t> high{0};
+            std::atomic<std::uint64_t> low{0};
+            std::atomic<std::uint32_t> index{empty_slot};
+        };
+
+        void copy_slot(xslot& dst, const xslot& src) noexcept
+        {
+            dst.high.store(src.high.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            dst.low.store(src.low.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            dst.index.store(src.index.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        void clear_slot(xslot& slot) noexcept
+        {
+            slot.high.store(0, std::memory_order_relaxed);
+            slot.low.store(0, std::memory_order_relaxed);
+            slot.index.store(empty_slot, std::memory_order_relaxed);
+        }
+
+        bool slot_holds(const xslot& slot, const xwidget_id& id) noexcept
+        {
+            return slot.high.load(std::memory_order_relaxed) == id.high &&
+                   slot.low.load(std::memory_order_relaxed) == id.low;
+        }
+
+        struct xslot_table
+        {
+            explicit xslot_table(std::size_t bits)
+                : mask((std::size_t(1) << bits) - 1),
+                  shift(static_cast<int>(64 - bits)),
+                  slots(new xslot[std::size_t(1) << bits])
+            {
+            }
+
+            std::size_t home(const xwidget_id& id) const noexcept
+            {
+                // Fibonacci hashing of the halves of the id
+                return static_cast<std::size_t>(((id.high ^ id.low) * 0x9E3779B97F4A7C15ULL) >> shift);
+            }
+
+            std::size_t mask;
+            int shift;
+            std::unique_ptr<xslot[]> slots;
+        };
+
+        bool is_alive(std::uint32_t generation) noexcept
+        {
+            return (generation & 1) != 0;
+        }
+    }
+
+    // Writers are serialized by the mutex, and bracket their changes of
+    // the slots with an odd sequence number. Readers look ids up without
+    // the lock, and retry when the sequence number has changed meanwhile.
+    struct xregistry::shard
+    {
+        shard();
+        ~shard();
+
+        xentry* entry(std::size_t index) const noexcept;
+        std::uint32_t new_entry();
+
+        std::uint32_t lookup(const xwidget_id& id) const noexcept;
+
+        std::size_t find_slot(const xwidget_id& id) const noexcept;
+        void erase_slot(std::size_t index) noexcept;
+        void grow();
+
+        void begin_write() noexcept;
+        void end_write() noexcept;
+
+        xholder erase_entry(std::size_t slot_index);
+
+        mutable std::mutex mutex;
+        std::atomic<std::uint32_t> sequence;
+        std::atomic<xentry*> chunks[chunk_count];
+        std::size_t entry_count;
+        std::vector<std::uint32_t> free_indices;
+        // The former tables are kept, since readers may still probe them
+        std::atomic<xslot_table*> table;
+        std::vector<std::unique_ptr<xslot_table>> tables;
+        std::size_t size;
+    };
+
+    xregistry::shard::shard()
+        : sequence(0), entry_count(0), size(0)
+    {
+        for (auto& chunk : chunks)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+        tables.emplace_back(new xslot_table(4));
+        table.store(tables.back().get(), std::memory_order_relaxed);
+    }
+
+    xregistry::shard::~shard()
+    {
+        for (auto& chunk : chunks)
+        {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    xentry* xregistry::shard::entry(std::size_t index) const noexcept
+    {
+        std::size_t position = index + (std::size_t(1) << first_chunk_bits);
+        std::size_t k = 0;
+        while ((position >> (first_chunk_bits + k + 1)) != 0)
+        {
+            ++k;
+        }
+        if (k >= chunk_count)
+        {
+            return nullptr;
+        }
+        xentry* chunk = chunks[k].load(std::memory_order_acquire);
+        return chunk != nullptr ? chunk + (position - (std::size_t(1) << (first_chunk_bits + k))) : nullptr;
+    }
+
+    std::uint32_t xregistry::shard::new_entry()
+    {
+        if (!free_indices.empty())
+        {
+            std::uint32_t res = free_indices.back();
+            free_indices.pop_back();
+            return res;
+        }
+        if (entry_count > max_index - 1)
+        {
+            throw std::runtime_error("Too many widgets in transport registry");
+        }
+        std::size_t position = entry_count + (std::size_t(1) << first_chunk_bits);
+        if ((position & (position - 1)) == 0)
+        {
+            // First entry of a chunk
+            std::size_t k = 0;
+            while ((position >> (first_chunk_bits + k + 1)) != 0)
+            {
+                ++k;
+            }
+            chunks[k].store(new xentry[std::size_t(1) << (first_chunk_bits + k)], std::memory_order_release);
+        }
+        return static_cast<std::uint32_t>(entry_count++);
+    }
+
+    std::uint32_t xregistry::shard::lookup(const xwidget_id& id) const noexcept
+    {
+        // Returns the index of the entry of id, or empty_slot
+        while (true)
+        {
+            std::uint32_t seq = sequence.load(std::memory_order_acquire);
+            if ((seq & 1) != 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const xslot_table* t = table.load(std::memory_order_acquire);
+            std::uint32_t res = empty_slot;
+            std::size_t index = t->home(id);
+            // A torn read may not meet an empty slot, it is bounded and retried
+            for (std::size_t probes = 0; probes <= t->mask; ++probes)
+            {
+                const xslot& sl = t->slots[index];
+                std::uint32_t entry_index = sl.index.load(std::memory_order_relaxed);
+                if (entry_index == empty_slot)
+                {
+                    break;
+                }
+                if (slot_holds(sl, id))
+                {
+                    res = entry_index;
+                    break;
+                }
+                index = (index + 1) & t->mask;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == seq)
+            {
+                return res;
+            }
+        }
+    }
+
+    std::size_t xregistry::shard::find_slot(const xwidget_id& id) const noexcept
+    {
+        // Returns the slot holding id, or the empty slot where it belongs.
+        // Only called with the lock held.
+        const xslot_table* t = table.load(std::memory_order_relaxed);
+        std::size_t index = t->home(id);
+        while (t->slots[index].index.load(std::memory_order_relaxed) != empty_slot && !slot_holds(t->slots[index], id))
+        {
+            index = (index + 1) & t->mask;
+        }
+        return index;
+    }
+
+    void xregistry::shard::erase_slot(std::size_t index) noexcept
+    {
+        // Backward shift deletion: the following slots of the cluster that
+        // do not sit at their home are moved back into the hole.
+        xslot_table* t = table.load(std::memory_order_relaxed);
+        std::size_t hole = index;
+        std::size_t next = (hole + 1) & t->mask;
+        while (t->slots[next].index.load(std::memory_order_relaxed) != empty_slot)
+        {
+            xwidget_id next_id;
+            next_id.high = t->slots[next].high.load(std::memory_order_relaxed);
+            next_id.low = t->slots[next].low.load(std::memory_order_relaxed);
+            std::size_t h = t->home(next_id);
+            // Whether h is cyclically in (hole, next]
+            bool stays = hole <= next ? (hole < h && h <= next) : (hole < h || h <= next);
+            if (!stays)
+            {
+                copy_slot(t->slots[hole], t->slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & t->mask;
+        }
+        clear_slot(t->slots[hole]);
+    }
+
+    void xregistry::shard::grow()
+    {
+        const xslot_table* former = table.load(std::memory_order_relaxed);
+        std::size_t bits = static_cast<std::size_t>(64 - former->shift) + 1;
+        std::unique_ptr<xslot_table> t(new xslot_table(bits));
+        for (std::size_t i = 0; i <= former->mask; ++i)
+        {
+            const xslot& sl = former->slots[i];
+            if (sl.index.load(std::memory_order_relaxed) != empty_slot)
+            {
+                xwidget_id id;
+                id.high = sl.high.load(std::memory_order_relaxed);
+                id.low = sl.low.load(std::memory_order_relaxed);
+                std::size_t index = t->home(id);
+                while (t->slots[index].index.load(std::memory_order_relaxed) != empty_slot)
+                {
+                    index = (index + 1) & t->mask;
+                }
+                copy_slot(t->slots[index], sl);
+            }
+        }
+        table.store(t.get(), std::memory_order_release);
+        tables.push_back(std::move(t));
+    }
+
+    void xregistry::shard::begin_write() noexcept
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void xregistry::shard::end_write() noexcept
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    xholder xregistry::shard::erase_entry(std::size_t slot_index)
+    {
+        // The holder is returned to be destroyed once the lock is released,
+        // since the destruction of a widget unregisters it.
+        std::uint32_t index = table.load(std::memory_order_relaxed)->slots[slot_index].index.load(std::memory_order_relaxed);
+        begin_write();
+        erase_slot(slot_index);
+        end_write();
+        xentry* e = entry(index);
+        xholder former = std::move(e->holder);
+        e->generation.fetch_add(1, std::memory_order_release);
+        free_indices.push_back(index);
+        --size;
+        return former;
+    }
+
+    constexpr xregistry::handle_type xregistry::npos;
+
+    xregistry::xregistry()
+        : p_shards(new shard[shard_count]), m_size(0)
+    {
+    }
+
+    xregistry::~xregistry()
+    {
+        // Destroying an owning holder destroys its widget, which unregisters
+        // itself: the holders are destroyed once removed from the registry.
+        for (std::size_t i = 0; i != shard_count; ++i)
+        {
+            shard& s = p_shards[i];
+            for (std::size_t j = 0; j <= s.table.load()->mask;)
+            {
+                xholder former;
+                {
+                    std::lock_guard<std::mutex> lock(s.mutex);
+                    if (s.table.load()->slots[j].index.load() == empty_slot)
+                    {
+                        ++j;
+                        continue;
+                    }
+                    // Erasing shifts the next slot into j
+                    former = s.erase_entry(j);
+                }
+                --m_size;
+            }
+        }
+    }
+
+    void xregistry::insert(xeus::xguid id, holder_type&& holder)
+    {
+        xwidget_id key = make_widget_id(id);
+        shard& s = get_shard(key);
+        holder_type former;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            std::size_t slot_index = s.find_slot(key);
+            xslot& sl = s.table.load(std::memory_order_relaxed)->slots[slot_index];
+            if (sl.index.load(std::memory_order_relaxed) != empty_slot)
+            {
+                // Replacing the holder of a moved widget. The generation
+                // stays odd, and tells the cached pointers to the former
+                // address that they are stale.
+                xentry* e = s.entry(sl.index.load(std::memory_order_relaxed));
+                former = std::move(e->holder);
+                e->holder = std::move(holder);
+                e->generation.fetch_add(2, std::memory_order_release);
+                return;
+            }
+
+            std::uint32_t index = s.new_entry();
+            xentry* e = s.entry(index);
+            e->id = key;
+            e->holder = std::move(holder);
+            e->generation.fetch_add(1, std::memory_order_release);
+
+            s.begin_write();
+            sl.high.store(key.high, std::memory_order_relaxed);
+            sl.low.store(key.low, std::memory_order_relaxed);
+            sl.index.store(index, std::memory_order_relaxed);
+            if (2 * ++s.size > s.table.load(std::memory_order_relaxed)->mask + 1)
+            {
+                s.grow();
+            }
+            s.end_write();
+        }
+        ++m_size;
+    }
+
     void xregistry::unregister(xeus::xguid id)
     {
-        m_storage.erase(id);
+        xwidget_id key = make_widget_id(id);
+        shard& s = get_shard(key);
+        holder_type former;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            std::size_t slot_index = s.find_slot(key);
+            if (s.table.load(std::memory_order_relaxed)->slots[slot_index].index.load(std::memory_order_relaxed) == empty_slot)
+            {
+                return;
+            }
+            former = s.erase_entry(slot_index);
+        }
+        --m_size;
+    }
+
+    auto xregistry::find(xeus::xguid id) -> holder_type&
+    {
+        return find(make_widget_id(id));
     }
 
-    auto xregistry::find(xeus::xguid id) -> typename storage_type::mapped_type&
+    auto xregistry::find(const xwidget_id& id) -> holder_type&
     {
-        auto it = m_storage.find(id);
-        if (it == m_storage.end())
+        handle_type h = handle(id);
+        if (h == npos)
         {
             throw std::runtime_error("Could not find specified id in transport registry");
         }
-        return it->second;
+        return get(h);
+    }
+
+    auto xregistry::handle(const xwidget_id& id) const -> handle_type
+    {
+        shard& s = get_shard(id);
+        std::uint32_t index = s.lookup(id);
+        if (index == empty_slot)
+        {
+            return npos;
+        }
+        return static_cast<handle_type>((index << shard_bits) | static_cast<std::uint32_t>(&s - p_shards.get()));
+    }
+
+    auto xregistry::get(handle_type handle) -> holder_type&
+    {
+        xentry* e = p_shards[handle & (shard_count - 1)].entry(handle >> shard_bits);
+        if (e == nullptr || !is_alive(e->generation.load(std::memory_order_acquire)))
+        {
+            throw std::runtime_error("Could not find specified handle in transport registry");
+        }
+        return e->holder;
+    }
+
+    auto xregistry::generation(handle_type handle) const noexcept -> generation_type
+    {
+        const xentry* e = p_shards[handle & (shard_count - 1)].entry(handle >> shard_bits);
+        return e != nullptr ? e->generation.load(std::memory_order_acquire) : generation_type(0);
+    }
+
+    std::size_t xregistry::size() const noexcept
+    {
+        return m_size.load();
+    }
+
+    auto xregistry::get_shard(const xwidget_id& id) const noexcept -> shard&
+    {
+        return p_shards[static_cast<std::size_t>(id.high ^ id.low) & (shard_count - 1)];
+    }
+
+    auto xregistry::holders() const -> std::vector<const holder_type*>
+    {
+        std::vector<const holder_type*> res;
+        for (std::size_t i = 0; i != shard_count; ++i)
+        {
+            const shard& s = p_shards[i];
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const xslot_table* t = s.table.load(std::memory_order_relaxed);
+            for (std::size_t j = 0; j <= t->mask; ++j)
+            {
+                std::uint32_t index = t->slots[j].index.load(std::memory_order_relaxed);
+                if (index != empty_slot)
+                {
+                    res.push_back(&(s.entry(index)->holder));
+                }
+            }
+        }
+        return res;
     }
-    
+
     xregistry& get_transport_registry()
     {
         static xregistry instance;
         return instance;
     }
+
+    namespace detail
+    {
+        xholder* find_registered(const xeus::xguid& id, std::uint32_t& handle, std::uint32_t& generation)
+        {
+            auto& registry = get_transport_registry();
+            handle = registry.handle(make_widget_id(id));
+            if (handle == xregistry::npos)
+            {
+                handle = unresolved_handle;
+                return nullptr;
+            }
+            generation = registry.generation(handle);
+            return &registry.get(handle);
+        }
+
+        bool same_registration(std::uint32_t handle, std::uint32_t generation) noexcept
+        {
+            return get_transport_registry().generation(handle) == generation;
+        }
+    }
 }
@@ -6,6 +6,8 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <cstddef>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -13,7 +15,9 @@
 #include "xeus/xcomm.hpp"
 #include "xeus/xinterpreter.hpp"
 
+#include "xwidgets/xbinary.hpp"
 #include "xwidgets/xfactory.hpp"
+#include "xwidgets/xregistry.hpp"
 #include "xwidgets/xwidgets_config.hpp"
 
 #include "xtarget.hpp"
@@ -53,11 +57,143 @@ namespace xw
         factory.make(std::move(comm), state, buffers);
     }
 
+    const char* get_widget_control_target_name()
+    {
+        return "jupyter.widget.control";
+    }
+
+    namespace
+    {
+        std::unique_ptr<xeus::xcomm>& get_control_comm()
+        {
+            static std::unique_ptr<xeus::xcomm> comm;
+            return comm;
+        }
+
+        // Records the path of each buffer reference held by j, the indices
+        // of the references being shifted by offset.
+        void collect_buffer_paths(const nl::json& j,
+                                  nl::json& path,
+                                  std::size_t offset,
+                                  nl::json& buffer_paths)
+        {
+            if (j.is_string())
+            {
+                const std::string& s = j.get_ref<const std::string&>();
+                if (is_buffer_reference(s))
+                {
+                    std::size_t index = offset + static_cast<std::size_t>(buffer_index(s));
+                    if (index < buffer_paths.size())
+                    {
+                        buffer_paths[index] = path;
+                    }
+                }
+            }
+            else if (j.is_object())
+            {
+                for (auto it = j.cbegin(); it != j.cend(); ++it)
+                {
+                    path.push_back(it.key());
+                    collect_buffer_paths(it.value(), path, offset, buffer_paths);
+                    path.erase(path.size() - 1);
+                }
+            }
+            else if (j.is_array())
+            {
+                for (std::size_t i = 0; i != j.size(); ++i)
+                {
+                    path.push_back(i);
+                    collect_buffer_paths(j[i], path, offset, buffer_paths);
+                    path.erase(path.size() - 1);
+                }
+            }
+        }
+
+        void send_widget_states(const xeus::xcomm& comm)
+        {
+            // The states of all the widgets are sent in a single message,
+            // their buffers being gathered in a single buffer sequence.
+            nl::json states = nl::json::object();
+            nl::json buffer_paths = nl::json::array();
+            xeus::buffer_sequence buffers;
+
+            get_transport_registry().for_each([&](const xholder& holder) {
+                nl::json state;
+                xeus::buffer_sequence widget_buffers;
+                holder.serialize_state(state, widget_buffers);
+
+                std::string id = holder.id();
+                if (!widget_buffers.empty())
+                {
+                    std::size_t offset = buffers.size();
+                    for (auto& buffer : widget_buffers)
+                    {
+                        buffer_paths.push_back(nullptr);
+                        buffers.push_back(std::move(buffer));
+                    }
+                    nl::json path = nl::json::array({id, "state"});
+                    collect_buffer_paths(state, path, offset, buffer_paths);
+                }
+
+                nl::json& model = states[id];
+                model["model_name"] = state["_model_name"];
+                model["model_module"] = state["_model_module"];
+                model["model_module_version"] = state["_model_module_version"];
+                model["state"] = std::move(state);
+            });
+
+            // Drop the buffers that are not referenced by any state
+            std::size_t count = 0;
+            for (std::size_t i = 0; i != buffers.size(); ++i)
+            {
+                if (!buffer_paths[i].is_null())
+                {
+                    if (count != i)
+                    {
+                        buffers[count] = std::move(buffers[i]);
+                        buffer_paths[count] = std::move(buffer_paths[i]);
+                    }
+                    ++count;
+                }
+            }
+            buffers.resize(count);
+            buffer_paths.erase(buffer_paths.begin() + static_cast<std::ptrdiff_t>(count), buffer_paths.end());
+
+            nl::json metadata;
+            metadata["version"] = XWIDGETS_PROTOCOL_VERSION;
+
+            nl::json data;
+            data["method"] = "update_states";
+            data["states"] = std::move(states);
+            data["buffer_paths"] = std::move(buffer_paths);
+
+            comm.send(std::move(metadata), std::move(data), std::move(buffers));
+        }
+
+        void handle_control_message(const xeus::xmessage& msg)
+        {
+            const nl::json& data = msg.content()["data"];
+            auto it = data.find("method");
+            if (it != data.end() && *it == "request_states" && get_control_comm() != nullptr)
+            {
+                send_widget_states(*get_control_comm());
+            }
+        }
+    }
+
+    void xcontrol_comm_opened(xeus::xcomm&& comm, const xeus::xmessage&)
+    {
+        // A front-end reconnecting opens a new control comm
+        auto& control_comm = get_control_comm();
+        control_comm.reset(new xeus::xcomm(std::move(comm)));
+        control_comm->on_message(handle_control_message);
+    }
+
     int register_widget_target()
     {
-        xeus::get_interpreter()
-            .comm_manager()
-            .register_comm_target(get_widget_target_name(), xobject_comm_opened);
+        auto& comm_manager = xeus::get_interpreter().comm_manager();
+        comm_manager.register_comm_target(get_widget_target_name(), xobject_comm_opened);
+        comm_manager.register_comm_target(get_widget_control_target_name(), xcontrol_comm_opened);
         return 0;
     }
 
@@ -0,0 +1,125 @@
+/***************************************************************************
+* Copyright (c) 2017, Sylvain Corlay and Johan Mabille                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "xwidgets/xticker.hpp"
+
+namespace xw
+{
+    // Shared with the clock thread and the posted frames, which may outlive
+    // the ticker or belong to a former start.
+    struct xticker::state
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopped = false;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> pending{false};
+        std::atomic<std::size_t> frames{0};
+        std::atomic<std::size_t> skipped{0};
+        tick_task task;
+    };
+
+    xticker::~xticker()
+    {
+        stop();
+    }
+
+    void xticker::stop()
+    {
+        if (p_state == nullptr)
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(p_state->mutex);
+            p_state->stopped = true;
+        }
+        p_state->cancelled.store(true);
+        p_state->condition.notify_one();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    bool xticker::running() const noexcept
+    {
+        return p_state != nullptr && !p_state->cancelled.load();
+    }
+
+    std::size_t xticker::frames() const noexcept
+    {
+        return p_state != nullptr ? p_state->frames.load() : 0;
+    }
+
+    std::size_t xticker::skipped() const noexcept
+    {
+        return p_state != nullptr ? p_state->skipped.load() : 0;
+    }
+
+    void xticker::start_impl(const xeus::xguid& id, duration_type period, tick_task&& task)
+    {
+        stop();
+        p_state = std::make_shared<state>();
+        p_state->task = std::move(task);
+        m_thread = std::thread(&xticker::run, p_state, id, period);
+    }
+
+    void xticker::run(std::shared_ptr<state> s, xeus::xguid id, duration_type period)
+    {
+        std::size_t frame = 0;
+        std::size_t skipped = 0;
+        clock_type::time_point next = clock_type::now() + period;
+
+        std::unique_lock<std::mutex> lock(s->mutex);
+        while (!s->condition.wait_until(lock, next, [&s]() { return s->stopped; }))
+        {
+            clock_type::time_point now = clock_type::now();
+            if (s->pending.exchange(true))
+            {
+                ++skipped;
+                ++s->skipped;
+            }
+            else
+            {
+                xtick tick = {frame, skipped, next};
+                skipped = 0;
+                detail::post_task(id, std::string(), [s, tick](xholder& holder) {
+                    if (!s->cancelled.load())
+                    {
+                        try
+                        {
+                            s->task(holder, tick);
+                        }
+                        catch (...)
+                        {
+                            s->pending.store(false);
+                            throw;
+                        }
+                        ++s->frames;
+                    }
+                    s->pending.store(false);
+                });
+            }
+            ++frame;
+
+            // Late by more than a period: the missed frames are dropped
+            next += period;
+            if (next <= now)
+            {
+                next = now + period;
+            }
+        }
+    }
+}
@@ -8,9 +8,12 @@
 
 #include "gtest/gtest.h"
 
+#include "xtest_kernel.hpp"
+
 int main(int argc, char* argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
+    xw::start_test_kernel();
     return RUN_ALL_TESTS();
 }
 
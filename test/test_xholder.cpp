@@ -9,9 +9,13 @@
 #include "gtest/gtest.h"
 
 #include <map>
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "xwidgets/xbutton.hpp"
+#include "xwidgets/xregistry.hpp"
 
 namespace xw
 {
@@ -110,4 +114,187 @@ namespace xw
         h2 = std::move(b22);
         h3 = b33;
     }
+
+    TEST(xholder, serialize_state)
+    {
+        button b;
+        b.description = "coincoin";
+        nl::json expected;
+        xeus::buffer_sequence buffers;
+        b.serialize_state(expected, buffers);
+
+        xholder h = make_id_holder(b.id());
+        nl::json state;
+        h.serialize_state(state, buffers);
+        ASSERT_EQ(expected, state);
+        ASSERT_EQ("coincoin", state["description"].get<std::string>());
+    }
+
+    TEST(xholder, id_holder)
+    {
+        xholder h;
+        {
+            button b;
+            b.description = "a";
+            h = make_id_holder(b.id());
+            ASSERT_EQ("a", h.template get<button>().description());
+
+            // The widget is registered again when moved
+            button b2 = std::move(b);
+            ASSERT_EQ(&b2, &h.template get<button>());
+        }
+        ASSERT_THROW(h.template get<button>(), std::runtime_error);
+
+        // The handle of the destroyed widget is reused
+        button b3;
+        ASSERT_THROW(h.template get<button>(), std::runtime_error);
+    }
+
+    TEST(xholder, weak_holder)
+    {
+        xholder h;
+        {
+            button b;
+            b.description = "a";
+            h = get_transport_registry().find(b.id());
+            ASSERT_EQ(&b, &h.template get<button>());
+
+            // The copy follows the widget when it is moved
+            button b2 = std::move(b);
+            ASSERT_EQ(&b2, &h.template get<button>());
+            ASSERT_EQ("a", h.template get<button>().description());
+        }
+        ASSERT_THROW(h.template get<button>(), std::runtime_error);
+    }
+
+    TEST(xholder, small_buffer)
+    {
+        button b;
+        b.description = "a";
+        button b2;
+        b2.description = "b";
+        std::vector<xholder> children = {make_id_holder(b.id()), make_owning_holder(std::move(b2))};
+        std::vector<xholder> copy = children;
+        ASSERT_EQ("a", copy[0].template get<button>().description());
+        ASSERT_EQ("b", copy[1].template get<button>().description());
+
+        // Swapping inline and heap implementations
+        swap(copy[0], copy[1]);
+        ASSERT_EQ("b", copy[0].template get<button>().description());
+        ASSERT_EQ("a", copy[1].template get<button>().description());
+
+        xholder moved(std::move(copy[1]));
+        ASSERT_EQ(b.id(), moved.id());
+        ASSERT_THROW(copy[1].id(), std::runtime_error);
+    }
+
+    TEST(xholder, pool)
+    {
+        // Blocks released by another thread are reused
+        struct block_type
+        {
+            double value[4];
+        };
+        using pool_type = detail::xholder_pool<block_type>;
+        void* block = pool_type::allocate(sizeof(block_type));
+        std::thread release([block]() {
+            pool_type::deallocate(block, sizeof(block_type));
+        });
+        release.join();
+        void* reused = pool_type::allocate(sizeof(block_type));
+        ASSERT_EQ(block, reused);
+        pool_type::deallocate(reused, sizeof(block_type));
+    }
+
+    TEST(xregistry, widget_id)
+    {
+        xwidget_id id = make_widget_id("0123456789abcdef-FEDCBA9876543210");
+        ASSERT_EQ(0x0123456789abcdefULL, id.high);
+        ASSERT_EQ(0xfedcba9876543210ULL, id.low);
+        ASSERT_TRUE(make_widget_id("not a guid") == make_widget_id("not a guid"));
+        ASSERT_TRUE(make_widget_id("not a guid") != make_widget_id("not a guid either"));
+    }
+
+    TEST(xregistry, insert_erase)
+    {
+        xregistry registry;
+        std::vector<xeus::xguid> ids;
+        for (std::size_t i = 0; i != 1000; ++i)
+        {
+            ids.push_back(xeus::new_xguid());
+            registry.insert(ids.back(), make_id_holder(ids.back()));
+        }
+        ASSERT_EQ(1000u, registry.size());
+
+        auto handle = registry.handle(make_widget_id(ids[999]));
+        for (std::size_t i = 0; i < 999; i += 2)
+        {
+            registry.unregister(ids[i]);
+        }
+        ASSERT_EQ(500u, registry.size());
+        ASSERT_THROW(registry.find(ids[0]), std::runtime_error);
+        for (std::size_t i = 1; i < 1000; i += 2)
+        {
+            ASSERT_EQ(xregistry::npos == registry.handle(make_widget_id(ids[i])), false);
+        }
+        ASSERT_EQ(handle, registry.handle(make_widget_id(ids[999])));
+    }
+
+    TEST(xregistry, concurrent)
+    {
+        xregistry registry;
+        std::atomic<int> failures(0);
+        std::vector<std::vector<xeus::xguid>> thread_ids(8);
+        for (auto& ids : thread_ids)
+        {
+            for (std::size_t i = 0; i != 2000; ++i)
+            {
+                ids.push_back(xeus::new_xguid());
+            }
+        }
+
+        std::vector<std::thread> threads;
+        for (const auto& ids : thread_ids)
+        {
+            threads.emplace_back([&registry, &failures, &ids]() {
+                for (std::size_t i = 0; i != ids.size(); ++i)
+                {
+                    const xeus::xguid& id = ids[i];
+                    registry.insert(id, make_id_holder(id));
+                    xwidget_id key = make_widget_id(id);
+                    auto handle = registry.handle(key);
+                    auto generation = registry.generation(handle);
+
+                    // Moving a widget replaces its holder, and changes the
+                    // generation of its handle
+                    registry.insert(id, make_id_holder(id));
+                    if (registry.handle(key) != handle || registry.generation(handle) == generation ||
+                        registry.get(handle).id() != id)
+                    {
+                        ++failures;
+                    }
+                    generation = registry.generation(handle);
+
+                    if (i % 2 == 1)
+                    {
+                        registry.unregister(id);
+                        if (registry.generation(handle) == generation || registry.handle(key) != xregistry::npos)
+                        {
+                            ++failures;
+                        }
+                    }
+                }
+                for (const auto& id : ids)
+                {
+                    registry.unregister(id);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        ASSERT_EQ(0, failures.load());
+        ASSERT_EQ(0u, registry.size());
+    }
 }
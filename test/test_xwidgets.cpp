@@ -8,24 +8,153 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "xwidgets/xbox.hpp"
+#include "xwidgets/xbuffer.hpp"
 #include "xwidgets/xbutton.hpp"
 #include "xwidgets/xcheckbox.hpp"
+#include "xwidgets/xcoroutine.hpp"
+#include "xwidgets/xdropdown.hpp"
 #include "xwidgets/xhtml.hpp"
+#include "xwidgets/ximage.hpp"
+#include "xwidgets/xinteract.hpp"
 #include "xwidgets/xlabel.hpp"
 #include "xwidgets/xlayout.hpp"
 #include "xwidgets/xnumeral.hpp"
+#include "xwidgets/xpaged_selection.hpp"
 #include "xwidgets/xpassword.hpp"
 #include "xwidgets/xplay.hpp"
+#include "xwidgets/xpost.hpp"
 #include "xwidgets/xprogress.hpp"
+#include "xwidgets/xselect.hpp"
 #include "xwidgets/xslider.hpp"
 #include "xwidgets/xtext.hpp"
 #include "xwidgets/xtextarea.hpp"
+#include "xwidgets/xticker.hpp"
 #include "xwidgets/xtogglebutton.hpp"
+#include "xwidgets/xtyped_array.hpp"
 #include "xwidgets/xvalid.hpp"
 
+#include "xtest_kernel.hpp"
+
 namespace xw
 {
+    // Reads the comm messages sent to the front-end by the widgets, as
+    // published by the test kernel
+    class message_log
+    {
+    public:
+
+        message_log()
+            : m_first(published_messages().size())
+        {
+        }
+
+        // States of the update messages of the widget
+        std::vector<nl::json> updates(const xcommon& widget) const
+        {
+            std::vector<nl::json> res;
+            for (const auto& data : update_data(widget))
+            {
+                res.push_back(data["state"]);
+            }
+            return res;
+        }
+
+        // Buffer paths of the update messages of the widget
+        std::vector<nl::json> update_buffer_paths(const xcommon& widget) const
+        {
+            std::vector<nl::json> res;
+            for (const auto& data : update_data(widget))
+            {
+                res.push_back(data["buffer_paths"]);
+            }
+            return res;
+        }
+
+        // Count of the messages of type msg_type sent on the comm id
+        std::size_t count(const std::string& msg_type, const xeus::xguid& id) const
+        {
+            std::size_t res = 0;
+            const auto& messages = published_messages();
+            for (std::size_t i = m_first; i < messages.size(); ++i)
+            {
+                if (messages[i].msg_type == msg_type && messages[i].content.value("comm_id", "") == std::string(id))
+                {
+                    ++res;
+                }
+            }
+            return res;
+        }
+
+        void clear()
+        {
+            m_first = published_messages().size();
+        }
+
+    private:
+
+        std::vector<nl::json> update_data(const xcommon& widget) const
+        {
+            std::vector<nl::json> res;
+            const auto& messages = published_messages();
+            for (std::size_t i = m_first; i < messages.size(); ++i)
+            {
+                const nl::json& content = messages[i].content;
+                if (messages[i].msg_type == "comm_msg" && content.value("comm_id", "") == std::string(widget.id())
+                    && content["data"].value("method", "") == "update")
+                {
+                    res.push_back(content["data"]);
+                }
+            }
+            return res;
+        }
+
+        std::size_t m_first;
+    };
+
+    // Delivers a message from the front-end to the comm of a widget
+    struct comm_access : xcommon
+    {
+        static xeus::xcomm& get(xcommon& widget)
+        {
+            xeus::xcomm& (xcommon::*comm)() = &comm_access::comm;
+            return (widget.*comm)();
+        }
+
+        static void patch(const xcommon& widget, nl::json&& patch, xeus::buffer_sequence&& buffers)
+        {
+            void (xcommon::*send)(nl::json&&, xeus::buffer_sequence&&) const = &comm_access::send_patch;
+            (widget.*send)(std::move(patch), std::move(buffers));
+        }
+    };
+
+    void receive(xcommon& widget, const nl::json& data, xeus::buffer_sequence buffers = xeus::buffer_sequence())
+    {
+        nl::json content;
+        content["comm_id"] = std::string(widget.id());
+        content["data"] = data;
+        xeus::xmessage message({}, nl::json::object(), nl::json::object(), nl::json::object(), std::move(content), std::move(buffers));
+        comm_access::get(widget).handle_message(message);
+    }
+
+    void receive_update(xcommon& widget, const nl::json& state)
+    {
+        receive(widget, {{"method", "update"}, {"state", state}, {"buffer_paths", nl::json::array()}});
+    }
+
     TEST(xwidgets, box)
     {
         hbox hb;
@@ -103,6 +232,62 @@ namespace xw
         ASSERT_EQ("description", l.description());
     }
 
+    TEST(xwidgets, interact)
+    {
+        auto fn = [](double x, bool negate, const std::string& unit) {
+            return std::to_string(negate ? -x : x) + unit;
+        };
+        auto w = interact(fn, std::make_pair(0., 10.), false, std::vector<std::string>({"m", "km"}));
+        auto shown = [](auto& i) {
+            return i.out().outputs()[0]["data"]["text/plain"].template get<std::string>();
+        };
+        ASSERT_EQ(5., w.control<0>().value());
+        ASSERT_EQ(0.1, w.control<0>().step());
+        auto n = interact([](int i) { return std::to_string(i); }, std::make_pair(0, 10));
+        ASSERT_EQ(1, n.control<0>().step());
+        ASSERT_FALSE(w.control<1>().value());
+        ASSERT_EQ("m", w.control<2>().value());
+        ASSERT_EQ(4u, w.widget().children().size());
+        ASSERT_EQ(1u, w.computations());
+        ASSERT_EQ(fn(5., false, "m"), shown(w));
+
+        // New arguments are computed once they stop changing
+        w.set_debounce(std::chrono::milliseconds(20));
+        w.control<0>().value = 2.;
+        w.control<0>().value = 3.;
+        w.control<1>().value = true;
+        ASSERT_EQ(1u, w.computations());
+        process_posted_tasks_for(std::chrono::milliseconds(200));
+        ASSERT_EQ(2u, w.computations());
+        ASSERT_EQ(fn(3., true, "m"), shown(w));
+
+        // Former arguments are taken from the cache at once
+        w.control<0>().value = 5.;
+        w.control<1>().value = false;
+        ASSERT_EQ(fn(5., false, "m"), shown(w));
+        process_posted_tasks_for(std::chrono::milliseconds(100));
+        ASSERT_EQ(2u, w.computations());
+        ASSERT_EQ(fn(5., false, "m"), shown(w));
+
+        // Without debounce, the values of a message lead to one computation
+        auto moved = std::move(w);
+        moved.set_debounce(std::chrono::milliseconds(0));
+        {
+            detail::xmessage_scope scope;
+            moved.control<0>().value = 7.;
+            moved.control<2>().value = "km";
+            ASSERT_EQ(2u, moved.computations());
+        }
+        process_posted_tasks();
+        ASSERT_EQ(3u, moved.computations());
+        ASSERT_EQ(fn(7., false, "km"), shown(moved));
+
+        moved.set_cache_capacity(1);
+        moved.control<0>().value = 2.;
+        moved.control<2>().value = "m";
+        ASSERT_EQ(5u, moved.computations());
+    }
+
     TEST(xwidgets, layout)
     {
         layout l;
@@ -131,6 +316,71 @@ namespace xw
         ASSERT_EQ(15, p.interval());
     }
 
+    TEST(xwidgets, ticker)
+    {
+        play p;
+        p.max = 3;
+        ASSERT_TRUE(p.advance());
+        ASSERT_TRUE(p.advance());
+        ASSERT_TRUE(p.advance());
+        ASSERT_FALSE(p.advance());
+        ASSERT_EQ(3, p.value());
+        p._repeat = true;
+        ASSERT_TRUE(p.advance());
+        ASSERT_EQ(0, p.value());
+
+        // Frames taking longer than the period are skipped
+        xticker ticker;
+        p.max = 1000;
+        ticker.start(p, std::chrono::milliseconds(2), [](play& w, const xtick&) {
+            ASSERT_TRUE(is_kernel_thread());
+            w.advance();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        });
+        ASSERT_TRUE(ticker.running());
+        process_posted_tasks_for(std::chrono::milliseconds(200));
+        ticker.stop();
+        ASSERT_FALSE(ticker.running());
+        ASSERT_GT(ticker.frames(), 0u);
+        ASSERT_GT(ticker.skipped(), 0u);
+        ASSERT_EQ(int(ticker.frames()), p.value());
+
+        int value = p.value();
+        process_posted_tasks();
+        ASSERT_EQ(value, p.value());
+
+        // On a kernel with a wakeup, the frames are run by its event loop,
+        // which runs the posted tasks when it is woken up
+        struct event_loop
+        {
+            std::mutex mutex;
+            std::condition_variable condition;
+            bool scheduled = false;
+        };
+        auto loop = std::make_shared<event_loop>();
+        set_kernel_wakeup([loop]() {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            loop->scheduled = true;
+            loop->condition.notify_one();
+        });
+        p.value = 0;
+        ticker.start(p, std::chrono::milliseconds(5), [](play& w, const xtick&) { w.advance(); });
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (ticker.frames() < 5 && std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::unique_lock<std::mutex> lock(loop->mutex);
+                loop->condition.wait_until(lock, deadline, [&loop]() { return loop->scheduled; });
+                loop->scheduled = false;
+            }
+            process_posted_tasks();
+        }
+        ticker.stop();
+        set_kernel_wakeup(nullptr);
+        ASSERT_GE(ticker.frames(), 5u);
+        ASSERT_EQ(int(ticker.frames()), p.value());
+    }
+
     TEST(xwidgets, progress_style)
     {
         progress_style p;
@@ -145,6 +395,115 @@ namespace xw
         ASSERT_EQ("vertical", p.orientation());
     }
 
+    TEST(xwidgets, selection)
+    {
+        std::vector<std::string> options;
+        for (int i = 0; i < 100; ++i)
+        {
+            options.push_back("option " + std::to_string(i));
+        }
+        options.push_back("option 42");
+
+        dropdown d(options, "option 0");
+        d.value = "option 42";
+        ASSERT_EQ(42u, d.index());
+        ASSERT_THROW(d.value = "option 100", std::runtime_error);
+
+        // Options of the same size, which may reuse the same storage
+        std::reverse(options.begin(), options.end());
+        d._options_labels = options;
+        ASSERT_EQ(0u, d.index());
+        d.value = "option 99";
+        ASSERT_EQ(1u, d.index());
+
+        // Options modified in place are found
+        d._options_labels()[2] = "renamed";
+        d.value = "renamed";
+        ASSERT_EQ(2u, d.index());
+
+        select_multiple s(options);
+        s.value = std::vector<std::string>({"option 0", "option 42"});
+        ASSERT_EQ(std::vector<std::size_t>({100, 0}), s.index());
+        ASSERT_THROW(s.value = std::vector<std::string>({"option 101"}), std::runtime_error);
+    }
+
+    TEST(xwidgets, paged_selection)
+    {
+        std::vector<std::string> options;
+        for (int i = 0; i < 2500; ++i)
+        {
+            options.push_back("option " + std::to_string(i));
+        }
+
+        paged_dropdown d(options, "option 1234");
+        ASSERT_EQ(1234u, d.position());
+        ASSERT_EQ(1200u, d._options_offset());
+        ASSERT_EQ(34u, d.index());
+        ASSERT_EQ("option 1234", d._options_labels()[d.index()]);
+        ASSERT_EQ(2500u, d._options_count());
+        ASSERT_EQ(100u, d._options_labels().size());
+
+        // Stand-in for a front-end requesting pages
+        auto request = [&d](std::size_t offset, std::size_t count, const std::string& prefix) {
+            nl::json content = {{"event", "page"}, {"offset", offset}, {"count", count}, {"prefix", prefix}};
+            d.handle_custom_message(content);
+            return d.options().reply(content);
+        };
+
+        std::vector<std::string> loaded;
+        for (std::size_t offset = 0; offset < d._options_count(); offset += 1000)
+        {
+            nl::json page = request(offset, 1000, "");
+            ASSERT_EQ(offset, page["offset"].get<std::size_t>());
+            for (const auto& label : page["labels"])
+            {
+                loaded.push_back(label.get<std::string>());
+            }
+        }
+        ASSERT_EQ(options, loaded);
+        ASSERT_EQ(xoption_store::max_page_size, request(0, 100000, "")["labels"].size());
+
+        nl::json filtered = request(1, 3, "option 123");
+        ASSERT_EQ(11u, filtered["total"].get<std::size_t>());
+        ASSERT_EQ(std::vector<std::size_t>({1230, 1231, 1232}), filtered["indices"].get<std::vector<std::size_t>>());
+        ASSERT_EQ("option 1230", filtered["labels"][0].get<std::string>());
+
+        // The window follows the selection
+        d.select(2042);
+        ASSERT_EQ("option 2042", d.value());
+        ASSERT_EQ(2000u, d._options_offset());
+        ASSERT_EQ(42u, d.index());
+        ASSERT_EQ("option 2000", d._options_labels()[0]);
+        ASSERT_THROW(d.value = "option 2500", std::runtime_error);
+        ASSERT_THROW(d.select(2500), std::out_of_range);
+
+        // The front-end selects in the window, and cannot change it
+        receive_update(d, {{"index", 7}, {"_options_count", 3}, {"_options_offset", 0}});
+        ASSERT_EQ("option 2007", d.value());
+        ASSERT_EQ(2500u, d._options_count());
+        ASSERT_EQ(2000u, d._options_offset());
+        d.handle_custom_message({{"event", "select"}, {"position", 12}});
+        ASSERT_EQ("option 12", d.value());
+        ASSERT_EQ(0u, d._options_offset());
+        ASSERT_EQ(12u, d.index());
+
+        std::size_t version = d._options_version();
+        d.set_options({"b", "option 12"});
+        ASSERT_EQ(version + 1, d._options_version());
+        ASSERT_EQ(1u, d.index());
+        d.set_options({"a", "b"});
+        ASSERT_EQ("a", d.value());
+        ASSERT_EQ(0u, d.position());
+
+        d.set_options({});
+        ASSERT_EQ("", d.value());
+        ASSERT_EQ(xoption_store::npos, d.position());
+        ASSERT_TRUE(d._options_labels().empty());
+        ASSERT_EQ(0u, d._options_count());
+        d.set_options({"c"});
+        ASSERT_EQ("c", d.value());
+    }
+
     TEST(xwidgets, slider_style)
     {
         slider_style s;
@@ -159,6 +518,741 @@ namespace xw
         ASSERT_EQ(2., s.value());
     }
 
+    TEST(xwidgets, property_table)
+    {
+        slider<double> s;
+        const auto& table = get_property_table(s);
+        ASSERT_NE(nullptr, table.find("value"));
+        ASSERT_NE(nullptr, table.find("_model_name"));
+        ASSERT_EQ(nullptr, table.find("unknown"));
+
+        nl::json patch = {{"value", 4.0}, {"max", 50.0}};
+        ASSERT_TRUE(table.apply(&s, patch, xeus::buffer_sequence()));
+        ASSERT_EQ(4., s.value());
+        ASSERT_EQ(50., s.max());
+
+        // The table recorded on s applies to other sliders
+        slider<double> s2;
+        ASSERT_TRUE(get_property_table(s2).apply(&s2, {{"value", 2.0}}, xeus::buffer_sequence()));
+        ASSERT_EQ(2., s2.value());
+        ASSERT_EQ(4., s.value());
+
+        ASSERT_FALSE(table.apply(&s, {{"value", 1.0}, {"unknown", 1}}, xeus::buffer_sequence()));
+        ASSERT_EQ(4., s.value());
+
+        nl::json state;
+        xeus::buffer_sequence buffers;
+        s.serialize_state(state, buffers);
+        ASSERT_EQ(table.size(), state.size());
+        ASSERT_EQ(4., state["value"].get<double>());
+        ASSERT_EQ("FloatSliderModel", state["_model_name"].get<std::string>());
+
+        nl::json partial;
+        table.serialize(&s, {"value", "unknown"}, partial, buffers);
+        ASSERT_EQ(1u, partial.size());
+        ASSERT_EQ(4., partial["value"].get<double>());
+    }
+
+    TEST(xwidgets, layout_state)
+    {
+        layout l;
+        l.min_width = "10px";
+        nl::json state;
+        xeus::buffer_sequence buffers;
+        l.serialize_state(state, buffers);
+        ASSERT_EQ("10px", state["min_width"].get<std::string>());
+
+        l.apply_patch({{"min_height", "20px"}}, buffers);
+        ASSERT_EQ("20px", l.min_height().value());
+    }
+
+    TEST(xwidgets, state_cache)
+    {
+        slider<double> s;
+        nl::json state;
+        xeus::buffer_sequence buffers;
+        s.serialize_state(state, buffers);
+        ASSERT_EQ(0., state["value"].get<double>());
+
+        s.value = 3.;
+        nl::json state2;
+        s.serialize_state(state2, buffers);
+        ASSERT_EQ(3., state2["value"].get<double>());
+        state2["value"] = 0.;
+        ASSERT_EQ(state, state2);
+
+        // Properties modified in place are sent with send_patch, or their
+        // observers are invoked
+        hbox b;
+        nl::json box_state;
+        b.serialize_state(box_state, buffers);
+        ASSERT_TRUE(box_state["children"].empty());
+        b.add(s);
+        box_state = nl::json();
+        b.serialize_state(box_state, buffers);
+        ASSERT_EQ(1u, box_state["children"].size());
+
+        b.children().push_back(make_id_holder(s.id()));
+        nl::json patch;
+        xwidgets_serialize(b.children(), patch["children"], buffers);
+        comm_access::patch(b, std::move(patch), xeus::buffer_sequence());
+        box_state = nl::json();
+        b.serialize_state(box_state, buffers);
+        ASSERT_EQ(2u, box_state["children"].size());
+
+        b.children().pop_back();
+        b.invoke_observers("children");
+        box_state = nl::json();
+        b.serialize_state(box_state, buffers);
+        ASSERT_EQ(1u, box_state["children"].size());
+
+        // Notified changes which are not sent yet
+        {
+            auto guard = s.hold_sync();
+            s.value = 4.;
+            nl::json held_state;
+            s.serialize_state(held_state, buffers);
+            ASSERT_EQ(4., held_state["value"].get<double>());
+        }
+        XSYNC_POLICY(s, value, sync_throttle(1.));
+        s.value = 5.;
+        s.value = 6.;
+        nl::json throttled_state;
+        s.serialize_state(throttled_state, buffers);
+        ASSERT_EQ(6., throttled_state["value"].get<double>());
+        XSYNC_POLICY(s, value, sync_immediate());
+    }
+
+    TEST(xwidgets, hold_sync)
+    {
+        slider<double> s;
+        message_log log;
+        {
+            auto tx = s.hold_sync();
+            s.value = 2.0;
+            s.min = 1.0;
+            {
+                auto nested = s.hold_sync();
+                s.value = 3.0;
+            }
+            ASSERT_EQ(3., s.value());
+            ASSERT_TRUE(log.updates(s).empty());
+        }
+        ASSERT_EQ(3., s.value());
+        ASSERT_EQ(1., s.min());
+
+        // One update holding the last value of each property
+        auto updates = log.updates(s);
+        ASSERT_EQ(1u, updates.size());
+        ASSERT_EQ(2u, updates[0].size());
+        ASSERT_EQ(3., updates[0]["value"].get<double>());
+        ASSERT_EQ(1., updates[0]["min"].get<double>());
+
+        // Moving a widget ends the transactions of the moved-from widget
+        log.clear();
+        {
+            auto tx = s.hold_sync();
+            s.value = 4.0;
+            slider<double> moved(std::move(s));
+            ASSERT_EQ(1u, log.updates(moved).size());
+            moved.value = 5.0;
+            ASSERT_EQ(2u, log.updates(moved).size());
+        }
+    }
+
+    TEST(xwidgets, unchanged_values)
+    {
+        slider<double> s;
+        message_log log;
+        s.value = 2.;
+        s.value = 2.;
+        ASSERT_EQ(1u, log.updates(s).size());
+
+        // Values received from the front-end are not sent back
+        receive_update(s, {{"value", 5.}});
+        ASSERT_EQ(5., s.value());
+        ASSERT_EQ(1u, log.updates(s).size());
+
+        // The front-end no longer has the value sent before
+        s.value = 2.;
+        ASSERT_EQ(2u, log.updates(s).size());
+        ASSERT_EQ(2., log.updates(s).back()["value"].get<double>());
+    }
+
+    TEST(xwidgets, inbound_buffers)
+    {
+        image im;
+        message_log log;
+        std::string bytes = "binary image content of the front-end";
+        xeus::buffer_sequence buffers;
+        buffers.emplace_back(bytes.data(), bytes.size());
+        nl::json data = {{"method", "update"}, {"state", nl::json::object()}, {"buffer_paths", {{"value"}}}};
+        receive(im, data, std::move(buffers));
+        ASSERT_EQ(bytes, std::string(im.value().begin(), im.value().end()));
+        // Compared with the buffer of the message, the value is not sent back
+        ASSERT_TRUE(log.updates(im).empty());
+
+        // A patch rejected by a validator does not leave the message held
+        slider<double> s;
+        s.validate<double>("value", [](auto&, double& proposal) {
+            if (proposal > 10.)
+            {
+                throw std::runtime_error("Invalid value");
+            }
+        });
+        ASSERT_THROW(receive_update(s, {{"value", 20.}}), std::runtime_error);
+        s.value = 5.;
+        ASSERT_EQ(std::vector<nl::json>({{{"value", 5.}}}), log.updates(s));
+    }
+
+    TEST(xwidgets, sync_policy)
+    {
+        slider<double> s;
+        XSYNC_POLICY(s, value, sync_throttle(10.));
+        ASSERT_TRUE(xsync_mode::throttle == s.sync_policy("value").mode);
+        ASSERT_TRUE(xsync_mode::immediate == s.sync_policy("min").mode);
+        s.value = 3.0;
+        ASSERT_EQ(3., s.value());
+        ASSERT_THROW(sync_throttle(0.), std::invalid_argument);
+
+        // Values assigned faster than the throttling interval: the leading
+        // one is sent at once, the last one once the interval has elapsed.
+        slider<double> t;
+        XSYNC_POLICY(t, value, sync_throttle(2.));
+        XSYNC_POLICY(t, description, sync_debounce(std::chrono::milliseconds(100)));
+        message_log log;
+        for (int i = 1; i <= 5; ++i)
+        {
+            t.value = double(i);
+        }
+        t.description = "a";
+        t.description = "b";
+        auto updates = log.updates(t);
+        ASSERT_EQ(1u, updates.size());
+        ASSERT_EQ(1., updates[0]["value"].get<double>());
+
+        // The kernel thread is woken up at the deadlines, and pending values
+        // are sent when it runs the posted tasks
+        std::atomic<int> wakeups(0);
+        set_kernel_wakeup([&wakeups]() { ++wakeups; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        set_kernel_wakeup(nullptr);
+        ASSERT_LT(0, wakeups.load());
+        ASSERT_EQ(1u, log.updates(t).size());
+        process_posted_tasks();
+        updates = log.updates(t);
+        ASSERT_EQ(3u, updates.size());
+        std::vector<nl::json> trailing = {updates[1], updates[2]};
+        ASSERT_NE(trailing.end(), std::find(trailing.begin(), trailing.end(), nl::json({{"value", 5.}})));
+        ASSERT_NE(trailing.end(), std::find(trailing.begin(), trailing.end(), nl::json({{"description", "b"}})));
+    }
+
+    TEST(xwidgets, deferred_sync)
+    {
+        slider<double> s;
+        slider<double> t;
+        message_log log;
+        set_deferred_sync(true);
+        ASSERT_TRUE(deferred_sync());
+        s.value = 2.0;
+        s.value = 3.0;
+        s.min = 1.0;
+        t.value = 4.0;
+        ASSERT_TRUE(log.updates(s).empty());
+        ASSERT_TRUE(log.updates(t).empty());
+        flush();
+        ASSERT_EQ(1u, log.updates(s).size());
+
+        // The held patches are flushed by the kernel wakeup, once the
+        // kernel thread is done with the request
+        std::atomic<int> wakeups(0);
+        set_kernel_wakeup([&wakeups]() { ++wakeups; });
+        s.value = 4.0;
+        set_kernel_wakeup(nullptr);
+        ASSERT_LT(0, wakeups.load());
+        ASSERT_EQ(1u, log.updates(s).size());
+        process_posted_tasks();
+        ASSERT_EQ(2u, log.updates(s).size());
+        set_deferred_sync(false);
+        ASSERT_FALSE(deferred_sync());
+        ASSERT_EQ(4., s.value());
+
+        // One update per widget, holding the last values
+        auto updates = log.updates(s);
+        ASSERT_EQ(2u, updates.size());
+        ASSERT_EQ(nl::json({{"value", 3.}, {"min", 1.}}), updates[0]);
+        ASSERT_EQ(nl::json({{"value", 4.}}), updates[1]);
+        updates = log.updates(t);
+        ASSERT_EQ(1u, updates.size());
+        ASSERT_EQ(nl::json({{"value", 4.}}), updates[0]);
+    }
+
+    TEST(xwidgets, post)
+    {
+        slider<double> s;
+        ASSERT_TRUE(is_kernel_thread());
+        std::thread worker([&s]() {
+            EXPECT_FALSE(is_kernel_thread());
+            for (int i = 1; i <= 100; ++i)
+            {
+                post(s, [i](slider<double>& w) { w.value = double(i); });
+            }
+            post(s, [](slider<double>& w) {
+                EXPECT_TRUE(is_kernel_thread());
+                w.description = "done";
+            });
+        });
+        worker.join();
+        ASSERT_EQ(0., s.value());
+        ASSERT_EQ("", s.description());
+        process_posted_tasks();
+        ASSERT_EQ(100., s.value());
+        ASSERT_EQ("done", s.description());
+
+        // Called from the kernel thread, the function is run at once
+        post(s, [](slider<double>& w) { w.description = "now"; });
+        ASSERT_EQ("now", s.description());
+
+        // Keyed functions replace the pending one with the same key
+        int runs = 0;
+        std::thread keyed([&s, &runs]() {
+            for (int i = 0; i != 10; ++i)
+            {
+                post(s, "step", [&runs, i](slider<double>& w) {
+                    ++runs;
+                    w.description = "step " + std::to_string(i);
+                });
+            }
+        });
+        keyed.join();
+        process_posted_tasks();
+        ASSERT_EQ(1, runs);
+        ASSERT_EQ("step 9", s.description());
+    }
+
+    TEST(xwidgets, assign_from_worker)
+    {
+        slider<double> s;
+        std::vector<double> observed;
+        s.observe("value", [&observed](const slider<double>& w) {
+            EXPECT_TRUE(is_kernel_thread());
+            observed.push_back(w.value());
+        });
+        message_log log;
+        std::thread worker([&s]() {
+            for (int i = 1; i <= 10; ++i)
+            {
+                s.value = double(i);
+            }
+            s.max = 50.;
+        });
+        worker.join();
+        // The values are assigned on the kernel thread
+        ASSERT_EQ(0., s.value());
+        ASSERT_EQ(0u, log.updates(s).size());
+        process_posted_tasks();
+        ASSERT_EQ(10., s.value());
+        ASSERT_EQ(50., s.max());
+        ASSERT_EQ(std::vector<double>({10.}), observed);
+        auto updates = log.updates(s);
+        ASSERT_EQ(2u, updates.size());
+        ASSERT_EQ(nl::json({{"value", 10.}}), updates[0]);
+        ASSERT_EQ(nl::json({{"max", 50.}}), updates[1]);
+
+        // A widget built on another thread is assigned in place until it is
+        // opened
+        std::unique_ptr<slider<double>> t;
+        std::thread builder([&t]() {
+            auto w = slider<double>::initialize().value(3.).finalize();
+            t.reset(new slider<double>(std::move(w)));
+        });
+        builder.join();
+        ASSERT_EQ(3., t->value());
+        process_posted_tasks();
+        ASSERT_EQ(0u, log.updates(*t).size());
+    }
+
+    TEST(xwidgets, worker_widget)
+    {
+        message_log log;
+        std::unique_ptr<slider<double>> s;
+        std::thread worker([&s]() {
+            slider<double> w;
+            // The open posted by w is run with the widget it was moved to
+            s.reset(new slider<double>(std::move(w)));
+        });
+        worker.join();
+        xeus::xguid id = s->id();
+        ASSERT_EQ(0u, log.count("comm_open", id));
+        process_posted_tasks();
+        ASSERT_EQ(1u, log.count("comm_open", id));
+
+        std::thread closer([&s]() { s.reset(); });
+        closer.join();
+        ASSERT_EQ(0u, log.count("comm_close", id));
+        ASSERT_EQ(xregistry::npos, get_transport_registry().handle(make_widget_id(id)));
+        process_posted_tasks();
+        ASSERT_EQ(1u, log.count("comm_close", id));
+    }
+
+    // Count of the callbacks run on the executor, shared with them so that
+    // the callbacks still queued on a failure do not outlive it
+    struct click_counter
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        int count = 0;
+    };
+
+    int clicks_run(xcallback_mode mode, int expected)
+    {
+        button b;
+        b.set_callback_mode(mode);
+        std::promise<void> release;
+        std::shared_future<void> gate = release.get_future().share();
+        auto counter = std::make_shared<click_counter>();
+        b.on_click([gate, counter]() {
+            gate.wait();
+            std::lock_guard<std::mutex> lock(counter->mutex);
+            ++counter->count;
+            counter->condition.notify_all();
+        });
+        for (int i = 0; i != 3; ++i)
+        {
+            b.handle_custom_message({{"event", "click"}});
+        }
+        std::unique_lock<std::mutex> lock(counter->mutex);
+        EXPECT_EQ(0, counter->count);
+        lock.unlock();
+        release.set_value();
+        lock.lock();
+        counter->condition.wait_for(lock, std::chrono::seconds(5), [&counter, expected]() {
+            return counter->count >= expected;
+        });
+        return counter->count;
+    }
+
+    TEST(xwidgets, cancellation)
+    {
+        auto s = std::make_unique<slider<double>>();
+        xcancellation_token first = s->cancellation_token("value");
+        xcancellation_token other = s->cancellation_token("description");
+        ASSERT_FALSE(first.cancelled());
+        ASSERT_FALSE(s->cancellation_token("value").cancelled());
+
+        // A new value cancels the work started for the former one
+        s->apply_patch({{"value", 2.}}, {});
+        ASSERT_TRUE(first.cancelled());
+        ASSERT_THROW(first.throw_if_cancelled(), xcancelled);
+        ASSERT_FALSE(other.cancelled());
+        xcancellation_token second = s->cancellation_token("value");
+        ASSERT_FALSE(second.cancelled());
+
+        // Superseded results are not applied
+        std::thread worker([&s, first, second]() {
+            post(*s, first, [](slider<double>& w) { w.description = "first"; });
+            post(*s, second, [](slider<double>& w) { w.description = "second"; });
+        });
+        worker.join();
+        process_posted_tasks();
+        ASSERT_EQ("second", s->description());
+        ASSERT_TRUE(other.cancelled());
+
+        xcancellation_token third = s->cancellation_token("value");
+        s.reset();
+        ASSERT_TRUE(third.cancelled());
+        ASSERT_FALSE(xcancellation_token().cancelled());
+    }
+
+    TEST(xwidgets, callback_mode)
+    {
+        button b;
+        int count = 0;
+        b.on_click([&count]() { ++count; });
+        ASSERT_EQ(xcallback_mode::synchronous, b.callback_mode());
+        b.handle_custom_message({{"event", "click"}});
+        ASSERT_EQ(1, count);
+
+        ASSERT_EQ(3, clicks_run(xcallback_mode::serialize, 3));
+        ASSERT_EQ(1, clicks_run(xcallback_mode::drop_while_busy, 1));
+        ASSERT_EQ(2, clicks_run(xcallback_mode::run_latest, 2));
+
+        // Errors are reported on the kernel thread, not rethrown there
+        button e;
+        e.set_callback_mode(xcallback_mode::serialize);
+        auto counter = std::make_shared<click_counter>();
+        std::string message;
+        e.on_callback_error([counter, &message](std::exception_ptr error) {
+            EXPECT_TRUE(is_kernel_thread());
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::runtime_error& err)
+            {
+                message = err.what();
+            }
+        });
+        e.on_click([counter]() {
+            std::lock_guard<std::mutex> lock(counter->mutex);
+            counter->condition.notify_all();
+            if (++counter->count == 1)
+            {
+                throw std::runtime_error("failed");
+            }
+        });
+        // The error of the first click is posted before the second one runs
+        e.handle_custom_message({{"event", "click"}});
+        e.handle_custom_message({{"event", "click"}});
+        {
+            std::unique_lock<std::mutex> lock(counter->mutex);
+            counter->condition.wait_for(lock, std::chrono::seconds(5), [&counter]() {
+                return counter->count == 2;
+            });
+        }
+        ASSERT_TRUE(message.empty());
+        ASSERT_NO_THROW(process_posted_tasks());
+        ASSERT_EQ("failed", message);
+
+        // The error of a widget destroyed in the meantime is logged
+        bool handled = false;
+        std::ostringstream log;
+        std::streambuf* former = std::cerr.rdbuf(log.rdbuf());
+        {
+            button f;
+            f.set_callback_mode(xcallback_mode::serialize);
+            f.on_callback_error([&handled](std::exception_ptr) { handled = true; });
+            f.on_click([]() { throw std::runtime_error("lost"); });
+            f.handle_custom_message({{"event", "click"}});
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (log.str().empty() && std::chrono::steady_clock::now() < deadline)
+        {
+            process_posted_tasks_for(std::chrono::milliseconds(10));
+        }
+        std::cerr.rdbuf(former);
+        ASSERT_FALSE(handled);
+        ASSERT_NE(std::string::npos, log.str().find("lost"));
+    }
+
+#ifdef XWIDGETS_HAS_COROUTINES
+    xtask wait_clicks(button& b, slider<double>& s, std::vector<double>& values)
+    {
+        while (true)
+        {
+            co_await b.clicked();
+            values.push_back(co_await changed(s.value));
+        }
+    }
+
+    TEST(xwidgets, coroutine)
+    {
+        button b;
+        slider<double> s;
+        std::vector<double> values;
+        xtask task = wait_clicks(b, s, values);
+
+        s.value = 1.;
+        process_posted_tasks();
+        b.handle_custom_message({{"event", "click"}});
+        process_posted_tasks();
+        // Resumed once the observers have run, with the last value
+        std::vector<double> observed;
+        s.observe("value", [&observed](const slider<double>& w) { observed.push_back(w.value()); });
+        s.value = 2.;
+        s.value = 3.;
+        ASSERT_TRUE(values.empty());
+        process_posted_tasks();
+        ASSERT_EQ(std::vector<double>({2., 3.}), observed);
+        ASSERT_EQ(std::vector<double>({3.}), values);
+
+        // The value is read from the widget the waiter has moved to
+        b.handle_custom_message({{"event", "click"}});
+        process_posted_tasks();
+        s.value = 4.;
+        slider<double> moved(std::move(s));
+        moved.value = 5.;
+        process_posted_tasks();
+        ASSERT_EQ(std::vector<double>({3., 5.}), values);
+        ASSERT_FALSE(task.done());
+
+        task.cancel();
+        ASSERT_TRUE(task.done());
+        b.handle_custom_message({{"event", "click"}});
+        moved.value = 6.;
+        process_posted_tasks();
+        ASSERT_EQ(2u, values.size());
+
+        // Destroying the widget cancels the wait
+        auto other = std::make_unique<button>();
+        xtask waiting = wait_clicks(*other, s, values);
+        other.reset();
+        ASSERT_TRUE(waiting.done());
+    }
+#endif
+
+    TEST(xwidgets, buffer)
+    {
+        std::vector<char> bytes(100, 'x');
+        xbuffer b(bytes);
+        ASSERT_EQ(100u, b.size());
+        ASSERT_TRUE(std::equal(bytes.cbegin(), bytes.cend(), b.begin()));
+
+        // Copies share the storage
+        xbuffer copy = b;
+        ASSERT_EQ(b.data(), copy.data());
+        ASSERT_EQ(b, copy);
+
+        // Messages share the storage, and keep it alive
+        zmq::message_t message = b.message();
+        ASSERT_EQ(static_cast<const void*>(b.data()), message.data());
+        const char* data = b.data();
+        b = xbuffer();
+        copy = xbuffer();
+        ASSERT_EQ(static_cast<const void*>(data), message.data());
+        ASSERT_EQ('x', message.data<char>()[99]);
+
+        // Buffers built from a message share its content
+        xbuffer received(message);
+        ASSERT_EQ(message.data(), static_cast<const void*>(received.data()));
+        ASSERT_EQ(100u, received.size());
+
+        std::vector<char> converted = received;
+        ASSERT_EQ(bytes, converted);
+        ASSERT_TRUE(xbuffer().empty());
+    }
+
+    TEST(xwidgets, binary_comparison)
+    {
+        std::string data1 = "binary buffer of more than thirty-two bytes";
+        std::string data2 = data1;
+        xeus::buffer_sequence b1;
+        b1.emplace_back(data1.data(), data1.size());
+        xeus::buffer_sequence b2;
+        b2.emplace_back(data2.data(), data2.size());
+        b2.emplace_back(data2.data(), data2.size() - 1);
+
+        nl::json j1 = {{"value", xbuffer_reference_prefix() + "0"}};
+        nl::json j2 = {{"value", xbuffer_reference_prefix() + "0"}};
+        nl::json j3 = {{"value", xbuffer_reference_prefix() + "1"}};
+
+        ASSERT_EQ(buffer_hash(data1.data(), data1.size()), buffer_hash(data2.data(), data2.size()));
+        ASSERT_TRUE(same_patch_entry(j1, b1, j2, b2));
+        ASSERT_FALSE(same_patch_entry(j1, b1, j3, b2));
+        ASSERT_EQ(patch_entry_hash(j1, b1), patch_entry_hash(j2, b2));
+
+        data2[0] = 'B';
+        xeus::buffer_sequence b4;
+        b4.emplace_back(data2.data(), data2.size());
+        ASSERT_FALSE(same_patch_entry(j1, b1, j2, b4));
+    }
+
+    TEST(xwidgets, buffer_paths)
+    {
+        xbuffer_paths to_check = {{"value"}, {"images", "*"}};
+        ASSERT_TRUE(to_check.contains("images"));
+        ASSERT_FALSE(to_check.contains("description"));
+
+        const std::string& prefix = xbuffer_reference_prefix();
+        nl::json patch;
+        patch["value"] = prefix + "2";
+        patch["images"] = {prefix + "0", "not a buffer", prefix + "1"};
+        xeus::buffer_sequence buffers(3);
+
+        nl::json paths;
+        extract_buffer_paths(to_check, patch, buffers, paths);
+        ASSERT_EQ(nl::json::array({"images", 0}), paths[0]);
+        ASSERT_EQ(nl::json::array({"images", 2}), paths[1]);
+        ASSERT_EQ(nl::json::array({"value"}), paths[2]);
+
+        nl::json state;
+        state["images"] = {nullptr, "not a buffer", nullptr};
+        insert_buffer_paths(state, paths);
+        ASSERT_EQ(patch, state);
+    }
+
+    template <class D>
+    class xarray_holder : public xwidget<D>
+    {
+    public:
+
+        using base_type = xwidget<D>;
+        using derived_type = D;
+
+        void apply_patch(const nl::json& patch, const xeus::buffer_sequence& buffers)
+        {
+            base_type::apply_patch(patch, buffers);
+            set_property_from_patch(array, patch, buffers);
+        }
+
+        XPROPERTY(xtyped_array<double>, derived_type, array);
+
+    protected:
+
+        xarray_holder()
+            : base_type()
+        {
+            this->buffer_paths() = {array_buffer_path("array")};
+        }
+
+        using base_type::base_type;
+    };
+
+    using array_holder = xmaterialize<xarray_holder>;
+
+    TEST(xwidgets, typed_array)
+    {
+        xtyped_array<double> a({2, 3}, 1.5);
+        a[4] = -2.;
+        ASSERT_EQ("float64", a.dtype());
+        ASSERT_EQ(6u, a.size());
+
+        nl::json j;
+        xeus::buffer_sequence buffers;
+        xwidgets_serialize(a, j, buffers);
+        ASSERT_EQ("float64", j["dtype"]);
+        ASSERT_EQ(nl::json({2, 3}), j["shape"]);
+        ASSERT_EQ(1u, buffers.size());
+        ASSERT_EQ(6u * sizeof(double), buffers[0].size());
+
+        xtyped_array<double> b;
+        xwidgets_deserialize(b, j, buffers);
+        ASSERT_TRUE(a == b);
+
+        // Inbound data of another dtype is converted
+        xtyped_array<float> f = {1.f, 2.5f};
+        nl::json jf;
+        xeus::buffer_sequence fbuffers;
+        xwidgets_serialize(f, jf, fbuffers);
+        xtyped_array<double> c;
+        xwidgets_deserialize(c, jf, fbuffers);
+        ASSERT_EQ(2.5, c[1]);
+
+        ASSERT_THROW(a.reshape({4}), std::invalid_argument);
+
+        // Through a widget property, the data is sent at its buffer path
+        array_holder w;
+        message_log log;
+        w.array = a;
+        ASSERT_EQ(1u, log.updates(w).size());
+        nl::json state = log.updates(w)[0];
+        ASSERT_EQ("float64", state["array"]["dtype"]);
+        ASSERT_EQ(nl::json({2, 3}), state["array"]["shape"]);
+        nl::json paths = nl::json::array({nl::json::array({"array", "buffer"})});
+        ASSERT_EQ(paths, log.update_buffer_paths(w)[0]);
+
+        // and the buffer of a message is read back at its buffer path
+        xtyped_array<double> d = {3., 4., 5.};
+        nl::json jd;
+        xeus::buffer_sequence dbuffers;
+        xwidgets_serialize(d, jd, dbuffers);
+        jd.erase("buffer");
+        nl::json data = {{"method", "update"}, {"state", {{"array", jd}}}, {"buffer_paths", paths}};
+        receive(w, data, std::move(dbuffers));
+        ASSERT_TRUE(d == w.array());
+        ASSERT_EQ(1u, log.updates(w).size());
+    }
+
     TEST(xwidgets, text)
     {
         text t;
@@ -0,0 +1,148 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xeus/xinterpreter.hpp"
+#include "xeus/xkernel.hpp"
+#include "xeus/xkernel_configuration.hpp"
+#include "xeus/xserver.hpp"
+
+#include "xtest_kernel.hpp"
+
+namespace xw
+{
+    namespace
+    {
+        std::vector<published_message>& messages()
+        {
+            static std::vector<published_message> res;
+            return res;
+        }
+
+        class test_interpreter : public xeus::xinterpreter
+        {
+        private:
+
+            void configure_impl() override
+            {
+            }
+
+            nl::json execute_request_impl(int, const std::string&, bool, bool, nl::json, bool) override
+            {
+                return {{"status", "ok"}};
+            }
+
+            nl::json complete_request_impl(const std::string&, int) override
+            {
+                return {{"status", "ok"}};
+            }
+
+            nl::json inspect_request_impl(const std::string&, int, int) override
+            {
+                return {{"status", "ok"}};
+            }
+
+            nl::json is_complete_request_impl(const std::string&) override
+            {
+                return {{"status", "complete"}};
+            }
+
+            nl::json kernel_info_request_impl() override
+            {
+                return nl::json::object();
+            }
+
+            void shutdown_request_impl() override
+            {
+            }
+        };
+
+        // Records the published messages, and has no socket
+        class test_server : public xeus::xserver
+        {
+        private:
+
+            void send_shell_impl(zmq::multipart_t&) override
+            {
+            }
+
+            void send_control_impl(zmq::multipart_t&) override
+            {
+            }
+
+            void send_stdin_impl(zmq::multipart_t&) override
+            {
+            }
+
+            void publish_impl(zmq::multipart_t& message, xeus::channel) override
+            {
+                // Frames: topic, delimiter, signature, header, parent header,
+                // metadata, content, then the buffers
+                std::size_t delimiter = 0;
+                while (delimiter < message.size() && frame(message, delimiter) != "<IDS|MSG>")
+                {
+                    ++delimiter;
+                }
+                if (delimiter + 5 >= message.size())
+                {
+                    return;
+                }
+                nl::json header = nl::json::parse(frame(message, delimiter + 2));
+                messages().push_back({header.value("msg_type", ""),
+                                      nl::json::parse(frame(message, delimiter + 5)),
+                                      message.size() - delimiter - 6});
+            }
+
+            void start_impl(zmq::multipart_t&) override
+            {
+            }
+
+            void abort_queue_impl(const listener&, long) override
+            {
+            }
+
+            void stop_impl() override
+            {
+            }
+
+            void update_config_impl(xeus::xconfiguration&) const override
+            {
+            }
+
+            static std::string frame(const zmq::multipart_t& message, std::size_t i)
+            {
+                return std::string(message[i].data<char>(), message[i].size());
+            }
+        };
+
+        std::unique_ptr<xeus::xserver> make_test_server(zmq::context_t&, const xeus::xconfiguration&)
+        {
+            return std::make_unique<test_server>();
+        }
+    }
+
+    void start_test_kernel()
+    {
+        xeus::xconfiguration config;
+        config.signature_scheme = "none";
+        static xeus::xkernel kernel(config,
+                                    "test",
+                                    std::make_unique<test_interpreter>(),
+                                    xeus::make_in_memory_history_manager(),
+                                    make_test_server);
+        kernel.start();
+    }
+
+    const std::vector<published_message>& published_messages()
+    {
+        return messages();
+    }
+}
@@ -0,0 +1,38 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XWIDGETS_TEST_KERNEL_HPP
+#define XWIDGETS_TEST_KERNEL_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace nl = nlohmann;
+
+namespace xw
+{
+    // Message published by the test kernel
+    struct published_message
+    {
+        std::string msg_type;
+        nl::json content;
+        std::size_t buffers;
+    };
+
+    // Starts a kernel whose server records the messages published on the
+    // iopub channel instead of sending them to a front-end, so that the
+    // tests see the comm messages of the widgets.
+    void start_test_kernel();
+
+    const std::vector<published_message>& published_messages();
+}
+
+#endif